@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*! \file almanac.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Multi-day sun and moon almanac C++ source code.
+ *
+ *  The Almanac class walks a range of dates for a site using the
+ *  Calendar-Date-Time Library rise/set routines in cdtlib.c.
+ */
+
+// Custom include files
+#include "almanac.h"
+#include "cdtlib.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+
+/*! \var static const double Radians
+ *  \brief Global constant defining the radians per degree.
+ */
+static const double Radians = 0.0174532925199433;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new Almanac for a site.
+ *
+ *  start() must be called before next().
+ *
+ *  \param longitude Longitude in degrees (west of Greenwich is positive).
+ *  \param latitude Latitude in degrees (north of the equator is positive).
+ *  \param gmtDiff Local time difference from GMT in hours.
+ *  \param moon If TRUE, moon rise and set are also determined.
+ */
+
+Almanac::Almanac( double longitude, double latitude, double gmtDiff,
+        bool moon ) :
+    m_lon(longitude),
+    m_sphi( sin( Radians * latitude ) ),
+    m_cphi( cos( Radians * latitude ) ),
+    m_gmt(gmtDiff),
+    m_mjd(0),
+    m_evaluations(0),
+    m_carry(false),
+    m_moon(moon)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of sun and moon ephemeris evaluations performed
+ *  since the last start().
+ *
+ *  \return Number of CDT_SineAltitude() calls.
+ */
+
+int Almanac::evaluations( void ) const
+{
+    return( m_evaluations );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Generates records for a range of consecutive dates.
+ *
+ *  \param jdate Julian date of the first day (the time is ignored).
+ *  \param days Number of days.
+ *  \param record Returned array of \a days AlmanacDay records.
+ *
+ *  \return Number of records generated.
+ */
+
+int Almanac::generate( double jdate, int days, AlmanacDay *record )
+{
+    start( jdate );
+    for ( int day = 0; day < days; day++ )
+    {
+        next( &record[day] );
+    }
+    return( ( days > 0 ) ? days : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the events of the next day and advances to the
+ *  following day.
+ *
+ *  \param record Returned AlmanacDay record.
+ */
+
+void Almanac::next( AlmanacDay *record )
+{
+    // Modified JD of local midnight adjusted to GMT, as in CDT_RiseSet()
+    double amjd = (double) m_mjd - m_gmt / 24.;
+    samples( CDT_SunRise, amjd, m_sunAlt );
+    if ( m_moon )
+    {
+        samples( CDT_MoonRise, amjd, m_moonAlt );
+    }
+    m_carry = true;
+
+    // Extract every event from the day's altitude curves
+    double hours[CDT_Spring];
+    int flags[CDT_Spring];
+    CDT_RiseSetAllSamples( m_sunAlt, m_moon ? m_moonAlt : 0, hours, flags );
+    record->mjd = m_mjd;
+    for ( int event = CDT_SunRise; event <= CDT_AstronomicalDusk; event++ )
+    {
+        int i = event - CDT_SunRise;
+        record->hours[i] = (float) hours[event];
+        record->flags[i] = (unsigned char) flags[event];
+    }
+    m_mjd++;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills a day's hourly altitude samples.
+ *
+ *  If the previous day was just computed, its hour 24 sample becomes this
+ *  day's hour 0 sample and only hours 1 through 24 are evaluated.
+ *
+ *  \param event #CDT_SunRise for the sun or #CDT_MoonRise for the moon.
+ *  \param amjd Modified Julian date of local midnight adjusted to GMT.
+ *  \param sinAlt Array of 25 samples to update.
+ */
+
+void Almanac::samples( int event, double amjd, double *sinAlt )
+{
+    int hour = 0;
+    if ( m_carry )
+    {
+        sinAlt[0] = sinAlt[24];
+        hour = 1;
+    }
+    for ( ; hour <= 24; hour++ )
+    {
+        sinAlt[hour] = CDT_SineAltitude( event, amjd, (double) hour, m_lon,
+            m_cphi, m_sphi );
+        m_evaluations++;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Starts a new range of dates.
+ *
+ *  \param jdate Julian date of the first day (the time is ignored).
+ */
+
+void Almanac::start( double jdate )
+{
+    m_mjd = (int) ( jdate - 2400000.5 );
+    m_evaluations = 0;
+    m_carry = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of almanac.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*! \file almanac.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Multi-day sun and moon almanac C++ API header.
+ *
+ *  The Almanac class walks a range of dates for a site using the
+ *  Calendar-Date-Time Library rise/set routines in cdtlib.c.
+ */
+
+#ifndef _ALMANAC_H_
+/*! \def _ALMANAC_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _ALMANAC_H_ 1
+
+//------------------------------------------------------------------------------
+/*! \struct AlmanacDay almanac.h
+ *
+ *  \brief Compact record of one day's rise, set, and twilight events.
+ *
+ *  Both arrays are indexed by (#CDT_Event - #CDT_SunRise), so element 0 is
+ *  sun rise and element 9 is astronomical dusk.
+ */
+
+struct AlmanacDay
+{
+    /*! \var int mjd
+        \brief Modified Julian day number of the local date
+        (its midnight is Julian date mjd + 2400000.5).
+    */
+    int             mjd;
+    /*! \var float hours[10]
+        \brief Local decimal hours of each event, or 0 if it does not occur.
+    */
+    float           hours[10];
+    /*! \var unsigned char flags[10]
+        \brief #CDT_Flag result of each event as returned by CDT_RiseSet(),
+        or #CDT_None for moon events that were not requested.
+    */
+    unsigned char   flags[10];
+};
+
+//------------------------------------------------------------------------------
+/*! \class Almanac almanac.h
+ *
+ *  \brief Streams AlmanacDay records for consecutive dates at one site.
+ *
+ *  Each day needs the sun (and optionally moon) altitude at local hours 0
+ *  through 24.  Hour 24 of one day is hour 0 of the next, so the Almanac
+ *  carries that sample forward instead of recomputing it, and all the
+ *  events of a day are extracted from the same curve by
+ *  CDT_RiseSetAllSamples().  A day therefore costs 24 solar ephemeris
+ *  evaluations (plus 24 lunar if requested) instead of up to 200 for eight
+ *  separate CDT_RiseSet() calls.
+ *
+ *  Results agree with CDT_RiseSet() to within floating point rounding of
+ *  the carried sample.
+ *
+ *  \sa CDT_RiseSetAll().
+ */
+
+class Almanac
+{
+// Public methods
+public:
+    Almanac( double longitude, double latitude, double gmtDiff,
+        bool moon=false ) ;
+
+    int      evaluations( void ) const ;
+    int      generate( double jdate, int days, AlmanacDay *record ) ;
+    void     next( AlmanacDay *record ) ;
+    void     start( double jdate ) ;
+
+// Private methods
+private:
+    void     samples( int event, double amjd, double *sinAlt ) ;
+
+// Protected member data
+protected:
+    /*! \var double m_lon
+        \brief Longitude in degrees (west of Greenwich is positive).
+    */
+    double  m_lon;
+    /*! \var double m_sphi
+        \brief Sine of the latitude.
+    */
+    double  m_sphi;
+    /*! \var double m_cphi
+        \brief Cosine of the latitude.
+    */
+    double  m_cphi;
+    /*! \var double m_gmt
+        \brief Local time difference from GMT in hours.
+    */
+    double  m_gmt;
+    /*! \var double m_sunAlt[25]
+        \brief Sines of the sun altitude for the current day.
+    */
+    double  m_sunAlt[25];
+    /*! \var double m_moonAlt[25]
+        \brief Sines of the moon altitude for the current day.
+    */
+    double  m_moonAlt[25];
+    /*! \var int m_mjd
+        \brief Modified Julian day number of the next day to emit.
+    */
+    int     m_mjd;
+    /*! \var int m_evaluations
+        \brief Number of ephemeris evaluations since start().
+    */
+    int     m_evaluations;
+    /*! \var bool m_carry
+        \brief TRUE if hour 0 of the next day was carried from the previous.
+    */
+    bool    m_carry;
+    /*! \var bool m_moon
+        \brief TRUE if moon rise and set are also determined.
+    */
+    bool    m_moon;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of almanac.h
+//------------------------------------------------------------------------------
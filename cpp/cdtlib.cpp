@@ -30,6 +30,7 @@
 
 /* Standard include files */
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 
 /*! \var static const double Radians
@@ -51,16 +52,274 @@ static const double D1 = 1236.853086;
  */
 static const double D0 = 0.827361;
 
+/*! \var static const int CDT_GridBlock
+ *  \brief Number of sites whose longitude and latitude terms
+ *  CDT_MoonPositionGrid() keeps in local arrays at one time.
+ */
+static const int CDT_GridBlock = 512;
+
 /*------------------------------------------------------------------------------
  *  Static function prototypes
  */
 
 static double cs( double degrees ) ;
+static int CDT_RiseSetScan( int event, const double *sinAlt, double amjd,
+    double lon, double cphi, double sphi, double *hours ) ;
+static int CDT_RiseSetThreshold( int event, double *sinh0 ) ;
 static void CDT_ImproveMoon( double *t0, double *b ) ;
 static void CDT_MiniMoon( double t, double *ra, double *dec ) ;
 static void CDT_MiniSun( double t, double *ra, double *dec ) ;
+static void CDT_SkyPosition( double gmst, double ra, double sinDec,
+    double cosDec, double lon, double lat, double *altitude,
+    double *azimuth ) ;
 static double sn( double degrees ) ;
 
+/*------------------------------------------------------------------------------
+ *  Compile-time rise/set event kernels
+ *
+ *  Each rise, set, dawn, and dusk event gets its own instantiation of the
+ *  Montenbruck & Pfleger search loop, with the event's threshold altitude,
+ *  direction, and body (sun or moon) as compile-time constants.  The
+ *  threshold sines fold to constants and the loop has no event or body
+ *  branches.  CDT_RiseSetScan() dispatches to them once per call.
+ */
+
+/*! \brief Compile-time properties of a rise, set, dawn, or dusk event.
+ *  \internal
+ */
+
+template <int Event> struct CDT_RiseSetEvent
+{
+    enum
+    {
+        /*! Non-zero if the event is a moon rise or set. */
+        Moon = ( Event == CDT_MoonRise || Event == CDT_MoonSet ),
+        /*! Non-zero if the event is a rise or dawn, zero for a set or dusk. */
+        Rise = ( Event == CDT_SunRise || Event == CDT_MoonRise
+              || Event == CDT_CivilDawn || Event == CDT_NauticalDawn
+              || Event == CDT_AstronomicalDawn ),
+        /*! Non-zero if the event is a dawn or dusk. */
+        Twilight = ( Event >= CDT_CivilDawn )
+    };
+
+    /*! \brief Sine of the event's threshold altitude (sun rise and set
+     *  at -50', moon rise and set at +8', twilights at -6, -12, and -18
+     *  degrees).  This is the only table of thresholds; the run-time
+     *  CDT_RiseSetThreshold() reads it through CDT_RiseSetEventThreshold().
+     */
+    static double sinh0( void )
+    {
+        return( sn( ( Event == CDT_SunRise || Event == CDT_SunSet )
+                    ? -50.0/60.0
+                  : ( Moon )
+                    ? 8.0/60.0
+                  : ( Event == CDT_CivilDawn || Event == CDT_CivilDusk )
+                    ? -6.0
+                  : ( Event == CDT_NauticalDawn || Event == CDT_NauticalDusk )
+                    ? -12.0
+                    : -18.0 ) );
+    }
+};
+
+/*! \brief Gets the threshold and direction of an \a Event for
+ *  CDT_RiseSetThreshold().
+ *  \internal
+ */
+
+template <int Event> static int CDT_RiseSetEventThreshold( double *sinh0 )
+{
+    *sinh0 = CDT_RiseSetEvent<Event>::sinh0();
+    return( CDT_RiseSetEvent<Event>::Rise ? 1 : -1 );
+}
+
+/*! \brief Determines the sine of the altitude of the moon (\a Moon
+ *  non-zero) or the sun; CDT_SineAltitude() without the body branch.
+ *  \internal
+ */
+
+template <int Moon> static double CDT_SineAltitudeBody( double mjd0,
+    double hour, double lambda, double cphi, double sphi )
+{
+    double ra, dec, mjd, t, tau;
+    mjd = mjd0 + hour/24.0;
+    t = (mjd - 51544.5) / 36525.0;
+    if ( Moon )
+    {
+        CDT_MiniMoon( t, &ra, &dec );
+    }
+    else
+    {
+        CDT_MiniSun( t, &ra, &dec );
+    }
+    tau = 15.0 * ( CDT_LocalMeanSiderealTime( mjd, lambda ) - ra );
+    return( sphi * sn(dec) + cphi * cs(dec) * cs(tau) );
+}
+
+/*! \brief Hourly altitude source for CDT_RiseSetKernel() that reads a day
+ *  of precomputed sines of the altitude.
+ *  \internal
+ */
+
+struct CDT_AltitudeSamples
+{
+    const double *m_sinAlt;
+    CDT_AltitudeSamples( const double *sinAlt ) : m_sinAlt( sinAlt ) {}
+    double operator()( int hour ) const { return( m_sinAlt[hour] ); }
+};
+
+/*! \brief Hourly altitude source for CDT_RiseSetKernel() that evaluates
+ *  the sine of the moon (\a Moon non-zero) or sun altitude on demand.
+ *  \internal
+ */
+
+template <int Moon> struct CDT_AltitudeCurve
+{
+    double m_amjd, m_lon, m_cphi, m_sphi;
+    CDT_AltitudeCurve( double amjd, double lon, double cphi, double sphi ) :
+        m_amjd( amjd ), m_lon( lon ), m_cphi( cphi ), m_sphi( sphi ) {}
+    double operator()( int hour ) const
+    {
+        return( CDT_SineAltitudeBody<Moon>( m_amjd, (double) hour, m_lon,
+            m_cphi, m_sphi ) );
+    }
+};
+
+/*! \brief Scans a day of hourly altitudes from \a sinAlt for the time of
+ *  \a Event.
+ *
+ *  This is the search loop of CDT_RiseSet(), from Montenbruch and Pfleger,
+ *  pages 51-54.  The scan stops as soon as both a rise and a set are found,
+ *  so an on-demand \a sinAlt source is evaluated no more than necessary.
+ *
+ *  \param sinAlt Source of the sine of the altitude at an integral hour
+ *  0 through 24.
+ *  \param *hours Returned decimals hours of the event.
+ *
+ *  \return One of the #CDT_Flag values documented for CDT_RiseSet().
+ *  \internal
+ */
+
+template <int Event, class Source> static int CDT_RiseSetKernel(
+    const Source &sinAlt, double *hours )
+{
+    typedef CDT_RiseSetEvent<Event> E;
+    const double sinh0 = E::sinh0();
+    double y_minus, y_0, y_plus;
+    double xe, ye, zero1, zero2;
+    double utset = 0., utrise = 0.;
+    int hour, above, rise, sett, nz;
+
+    /* Start */
+    hour = 1;
+    y_minus = sinAlt( hour - 1 ) - sinh0;
+    above = (y_minus > 0.);
+    rise = 0;
+    sett = 0;
+
+    /* Loop over search intervals from [0h-2h] to [22h-24h] */
+    do
+    {
+        y_0    = sinAlt( hour )     - sinh0;
+        y_plus = sinAlt( hour + 1 ) - sinh0;
+        nz = CDT_QuadraticRoots( y_minus, y_0, y_plus, &xe, &ye, &zero1, &zero2 );
+        if ( nz == 1 )
+        {
+            if ( y_minus < 0.0 )
+            {
+                utrise = hour + zero1;
+                rise = 1;
+            }
+            else
+            {
+                utset = hour + zero1;
+                sett = 1;
+            }
+        }
+        else if ( nz == 2 )
+        {
+            if ( ye < 0.0 )
+            {
+                utrise = hour + zero2;
+                utset = hour + zero1;
+            }
+            else
+            {
+                utrise = hour + zero1;
+                utset = hour + zero2;
+            }
+            rise = 1;
+            sett = 1;
+        }
+        if ( rise && sett )
+        {
+            break;
+        }
+        /* Prepare for next interval */
+        y_minus = y_plus;
+        hour += 2;
+    } while ( hour < 25 );
+
+    /* Store results */
+    if ( E::Rise && rise )
+    {
+        *hours = utrise;
+        return( CDT_Rises );
+    }
+    if ( ! E::Rise && sett )
+    {
+        *hours = utset;
+        return( CDT_Sets );
+    }
+    if ( rise || sett )
+    {
+        return( E::Rise ? CDT_NeverRises : CDT_NeverSets );
+    }
+    /* No rise or set occurred, so always above or always below */
+    if ( E::Twilight )
+    {
+        return( above ? CDT_Light : CDT_Dark );
+    }
+    return( above ? CDT_Visible : CDT_Invisible );
+}
+
+/*! \brief Runs the CDT_RiseSetKernel() for \a Event on either a day of
+ *  precomputed altitudes (if \a sinAlt is not NULL) or the on-demand
+ *  altitude curve.
+ *  \internal
+ */
+
+template <int Event> static int CDT_RiseSetDispatch( const double *sinAlt,
+    double amjd, double lon, double cphi, double sphi, double *hours )
+{
+    if ( sinAlt )
+    {
+        return( CDT_RiseSetKernel<Event>( CDT_AltitudeSamples( sinAlt ),
+            hours ) );
+    }
+    return( CDT_RiseSetKernel<Event>(
+        CDT_AltitudeCurve<CDT_RiseSetEvent<Event>::Moon>( amjd, lon, cphi,
+            sphi ), hours ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the elevation factor of the optical air mass.
+ *
+ *  The MTCLIM optical air mass is this factor divided by the sine of the sun
+ *  altitude.  Since it depends only upon the site elevation, raster and
+ *  station callers compute it once per site.
+ *
+ *  \param elev Site elevation in meters.
+ *
+ *  \return Optical air mass elevation factor [0..1].
+ *
+ *  \sa CDT_SolarRadiation(), CDT_SolarRadiationNormal().
+ */
+
+double CDT_AirMassElevationFactor( double elev )
+{
+    return( exp(-0.0001467 * (elev / 3.2808) ) );
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the Western calendar date from the Julian date.
  *
@@ -70,7 +329,12 @@ static double sn( double degrees ) ;
  *
  *  I used Montenbruck & Pfleger (p 13) because it gave the correct calendar
  *  date for Julian date 1.0, whereas the Meeus (p 26) and Duffett-Smith (p 11)
- *  algorithms said Julian date 1 is -4712 Jan 02.
+ *  algorithms said Julian date 1 is -4712 Jan 02.  The date and time are
+ *  now determined in integer arithmetic by CDT_JulianDateSplit(),
+ *  CDT_DayNumberDate(), and CDT_MillisecondTime(), which give the same
+ *  dates but round (rather than truncate) the time to the nearest
+ *  millisecond, so CDT_JulianDate() and CDT_CalendarDate() are an exact
+ *  round trip.
  *
  *  \warning No date or time validation is performed.
  *  \param jdate Julian date as returned by CDT_JulianDate().
@@ -89,35 +353,12 @@ static double sn( double degrees ) ;
 void CDT_CalendarDate( double jdate, int *year, int *month, int *day,
             int *hour, int *minute, int *second, int *millisecond )
 {
-    int b, d, f;
-    double jd0, c, e, dh, dm, ds, ms;
-
-    jd0 = (double) ( (long) ( jdate + 0.5 ) );
+    long jdn;
+    int ms;
 
-    if ( jd0 < 2299161.0 )
-    {
-        c = jd0 + 1524.0;
-    }
-    else
-    {
-        b = (int) ( ( jd0 - 1867216.25 ) / 36524.25 );
-        c = jd0 + (b - (int) ( b / 4 ) ) + 1525.0;
-    }
-    d = (int) ( (c - 122.1) / 365.25 );
-    e = 365.0 * d + (int) ( d / 4 );
-    f = (int) ( (c - e) / 30.6001 );
-
-    *day = (int) ( c - e + 0.5 ) - (int) ( 30.6001 * f );
-    *month = f - 1 - 12 * (int) ( f / 14 );
-    *year = d - 4715 - (int) ( ( 7 + *month ) / 10 );
-    dh = 24.0 * ( jdate + 0.5 - jd0 );
-    *hour = (int) dh;
-    dm = 60. * (dh - (double) *hour);
-    *minute = (int) dm;
-    ds = 60. * (dm - (double) *minute);
-    *second = (int) ds;
-    ms = 1000. * (ds - (double) *second);
-    *millisecond = (int) ms;
+    CDT_JulianDateSplit( jdate, &jdn, &ms );
+    CDT_DayNumberDate( jdn, year, month, day );
+    CDT_MillisecondTime( ms, hour, minute, second, millisecond );
     return;
 }
 
@@ -136,6 +377,142 @@ static double cs( double degrees )
     return cos( Radians * degrees );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the Julian day number of a Western (Julian-Gregorian)
+ *  calendar date in integer arithmetic.
+ *
+ *  The Julian day number is the Julian date at \e noon of the date, so
+ *  midnight starting the date is the day number - 0.5.  As in
+ *  CDT_JulianDate(), the Julian calendar is used through 1582 Oct 4 and the
+ *  Gregorian calendar on and after 1582 Oct 15.
+ *
+ *  In the style of Neri and Schneider, the date is shifted onto a
+ *  computational calendar whose years start on March 1 (so the leap day
+ *  falls at the end) and whose year count starts 4800 years before 4713
+ *  B.C. (a whole number of 400 year Gregorian cycles), so every quantity is
+ *  non-negative and every integer division is an exact floor.  There are no
+ *  floating point operations or conversions.
+ *
+ *  \warning No date validation is performed.
+ *
+ *  \param year  Julian-Gregorian year (-4712 (4713 B.C.) or greater).
+ *  \param month Month of the year (1-12).
+ *  \param day   Day of the month (1-31).
+ *
+ *  \return Julian day number of the date.
+ *
+ *  \sa CDT_DayNumberArray(), CDT_DayNumberDate(), CDT_JulianDate().
+ */
+
+long CDT_DayNumber( int year, int month, int day )
+{
+    long y, m, jdn;
+
+    /* March-based computational year and month (March = 0) */
+    y = (long) year + 4800 - ( month <= 2 );
+    m = ( month <= 2 ) ? month + 9 : month - 3;
+    jdn = day + ( 153 * m + 2 ) / 5 + 365 * y + y / 4;
+    if ( 10000L * year + 100 * month + day >= 15821015L )
+    {
+        return( jdn - y / 100 + y / 400 - 32045 );
+    }
+    return( jdn - 32083 );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the Julian day numbers of arrays of Western
+ *  (Julian-Gregorian) calendar dates.
+ *
+ *  This is the batch form of CDT_DayNumber().
+ *
+ *  \param n      Number of elements in each array.
+ *  \param year   Array of Julian-Gregorian years.
+ *  \param month  Array of months of the year (1-12).
+ *  \param day    Array of days of the month (1-31).
+ *  \param jdn    Returned array of Julian day numbers.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_DayNumber().
+ */
+
+void CDT_DayNumberArray( int n, const int *year, const int *month,
+        const int *day, long *jdn )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        jdn[i] = CDT_DayNumber( year[i], month[i], day[i] );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the Western (Julian-Gregorian) calendar date of a
+ *  Julian day number in integer arithmetic.
+ *
+ *  This is the exact inverse of CDT_DayNumber(), and gives the same dates
+ *  as CDT_CalendarDate() (which now calls it).  The day number is shifted
+ *  onto the same March-based computational calendar (Richards' algorithm),
+ *  so there are no floating point operations or conversions.
+ *
+ *  \param jdn    Julian day number (0 or greater).
+ *  \param *year  Returned Julian-Gregorian year (-4712 or greater).
+ *  \param *month Returned month of the year (1-12).
+ *  \param *day   Returned day of the month (1-31).
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_DayNumber(), CDT_DayNumberDateArray(), CDT_CalendarDate().
+ */
+
+void CDT_DayNumberDate( long jdn, int *year, int *month, int *day )
+{
+    long f, e, h;
+
+    /* Days since March 1 of the first computational year */
+    f = jdn + 1401;
+    if ( jdn >= 2299161 )
+    {
+        /* Gregorian century corrections */
+        f += ( ( ( 4 * jdn + 274277 ) / 146097 ) * 3 ) / 4 - 38;
+    }
+    e = 4 * f + 3;
+    h = 5 * ( ( e % 1461 ) / 4 ) + 2;
+    *day = (int) ( ( h % 153 ) / 5 + 1 );
+    *month = (int) ( ( h / 153 + 2 ) % 12 + 1 );
+    *year = (int) ( e / 1461 - 4716 + ( 14 - *month ) / 12 );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the Western (Julian-Gregorian) calendar dates of an
+ *  array of Julian day numbers.
+ *
+ *  This is the batch form of CDT_DayNumberDate().
+ *
+ *  \param n      Number of elements in each array.
+ *  \param jdn    Array of Julian day numbers.
+ *  \param year   Returned array of Julian-Gregorian years.
+ *  \param month  Returned array of months of the year (1-12).
+ *  \param day    Returned array of days of the month (1-31).
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_DayNumberDate().
+ */
+
+void CDT_DayNumberDateArray( int n, const long *jdn, int *year, int *month,
+        int *day )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_DayNumberDate( jdn[i], &year[i], &month[i], &day[i] );
+    }
+    return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the day-of-the week index from the Julian date \a jdate.
  *
@@ -465,6 +842,30 @@ double CDT_FractionalPart( double value )
     return( value );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the unreduced Greenwich mean sidereal time for the
+ *  modified Julian date \a mjd.
+ *
+ *  From Montenbruch and Pfleger, page 41.
+ *
+ *  \param mjd Modified Julian date (JD - 2400000.5)
+ *
+ *  \return The Greenwich mean sidereal time in hours, \e not reduced to the
+ *  range [0..24), as stored in CDT_SunEphemeris::gmst and
+ *  CDT_MoonEphemeris::gmst.
+ */
+
+double CDT_GreenwichSiderealTime( double mjd )
+{
+    double mjd0, ut, t;
+
+    mjd0 = (int) mjd;
+    ut   = 24. * (mjd - mjd0);
+    t    = (mjd0 - 51544.5) / 36525.0;
+    return( 6.697374558 + 1.0027379093 * ut
+         + ( 8640184.812866 + ( 0.093104-6.2e-6 * t ) * t ) * t / 3600.0 );
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Improves an approximation for the time of the new moon.
  *
@@ -565,12 +966,13 @@ static void CDT_ImproveMoon( double *t0, double *b )
  *
  *  \warning No date or time validation is performed.
  *
- *  \bug
- *  While all authors agree that the Julian Date starts at zero at 12:00
- *  \e noon of 4713 B.C. January  1, the Duffett-Smith and Meeus algorithms
- *  actually yields a JD of 1.0 for this date and time!  The function here
- *  correctly reproduces all the examples in their texts, but yield a JD of
- *  1.0 for -4712 Jan 1 12:00.
+ *  The Duffett-Smith and Meeus algorithms truncate the (365.25 * year) term
+ *  toward zero, which yields a JD of 1.0 for 4713 B.C. January 1 at 12:00
+ *  \e noon and is a day late for every negative year that is not a leap
+ *  year.  The day number is now determined in integer arithmetic by
+ *  CDT_DayNumber(), which rounds toward negative infinity, so this function
+ *  is the exact inverse of CDT_CalendarDate() for all years and is
+ *  unchanged for years 1 A.D. and later.
  *
  *  \htmlonly
  *  <table>
@@ -579,15 +981,10 @@ static void CDT_ImproveMoon( double *t0, double *b )
  *  <tr><td>1980 Jan 40 00:00:00</td><td>2,444,238.50</td><td>(Duffett-Smith, p10)</td></tr>
  *  <tr><td>1957 Oct 04 19:26:24</td><td>2,436,116.31</td><td>(Meeus, p23)</td></tr>
  *  <tr><td>0333 Jan 27 12:00:00</td><td>1,842,713.00</td><td>(Meeus, p24)</td></tr>
- *  <tr><td>-4712 Jan 01 12:00:00</td><td>1.00</td><td>Should be 0.0! </td>
+ *  <tr><td>-4712 Jan 01 12:00:00</td><td>0.00</td><td>(formal definition)</td>
  *  </table>
- *  Note the last example.
  *  \endhtmlonly
  *
- *  While this certainly deviates from the formal definition of JD, I will
- *  continue to use this algorithm since I also use their other algorithms
- *  for Julian-to-calendar conversions and astronomical date derivations.
- *
  *  \param year            -4712 (4713 B.C.) or greater
  *  \param month           Month of the year (1-12)
  *  \param day             Day of the month (1-31)
@@ -602,28 +999,49 @@ static void CDT_ImproveMoon( double *t0, double *b )
 double CDT_JulianDate( int year, int month, int day,
             int hour, int minute, int second, int millisecond )
 {
-    double jdate;
-    int a, b, c, d;
+    /* Sum in the same order as the Meeus formula so results are unchanged */
+    return( (double) ( CDT_DayNumber( year, month, day ) - 1720995L )
+          + CDT_DecimalDay( hour, minute, second, millisecond )
+          + 1720994.5 );
+}
 
-    jdate = 10000 * year + 100 * month + day;
-    if ( month <= 2 )
-    {
-        year--;
-        month+= 12;
-    }
-    a = 0;
-    b = 0;
-    if ( jdate >= 15821015.0 )
+/*----------------------------------------------------------------------------*/
+/*! \brief Splits a Julian date into its Julian day number and the
+ *  millisecond of the day, rounded to the nearest millisecond.
+ *
+ *  A Julian date near the present carries only about 40 microseconds of
+ *  precision, so its fraction of a day seldom falls exactly on a
+ *  millisecond; truncating it would turn about half of all exact times
+ *  into the preceding millisecond.  Rounding to the nearest millisecond
+ *  makes CDT_JulianDate() and this function (and so CDT_CalendarDate(),
+ *  which calls it) an exact round trip for every millisecond of every
+ *  date.
+ *
+ *  \param jdate             Julian date as returned by CDT_JulianDate().
+ *  \param *jdn              Returned Julian day number of the date.
+ *  \param *millisecondOfDay Returned milliseconds since midnight
+ *                           (0-86399999).
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_DayNumberDate(), CDT_MillisecondTime().
+ */
+
+void CDT_JulianDateSplit( double jdate, long *jdn, int *millisecondOfDay )
+{
+    double x;
+    long ms;
+
+    x = floor( jdate + 0.5 );
+    ms = (long) floor( ( jdate + 0.5 - x ) * 86400000. + 0.5 );
+    *jdn = (long) x;
+    if ( ms >= 86400000L )
     {
-        a = (int) (year / 100);
-        b = 2 - a + (int) (a/4);
+        ( *jdn )++;
+        ms -= 86400000L;
     }
-    c = (int) (365.25 * year);
-    d = (int) (30.6001 * ( month + 1 ));
-    jdate = b + c + d + day
-          + CDT_DecimalDay( hour, minute, second, millisecond )
-          + 1720994.5;
-    return( jdate );
+    *millisecondOfDay = (int) ms;
+    return;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -681,38 +1099,100 @@ int CDT_LeapYear( int year )
 
 double CDT_LocalMeanSiderealTime( double mjd, double lambda )
 {
-    double mjd0, ut, t, gmst;
-
-    mjd0 = (int) mjd;
-    ut   = 24. * (mjd - mjd0);
-    t    = (mjd0 - 51544.5) / 36525.0;
-    gmst = 6.697374558 + 1.0027379093 * ut
-         + ( 8640184.812866 + ( 0.093104-6.2e-6 * t ) * t ) * t / 3600.0;
+    double gmst = CDT_GreenwichSiderealTime( mjd );
     return( 24.0 * CDT_FractionalPart( (gmst - lambda/15.0) / 24.0 ) );
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \brief Determines the milliseconds elapsed since midnight.
+/*! \brief Determines the GMT time of the new moon of the \a lunation.
  *
- *  \param hour            Hours past midnight (0-23).
- *  \param minute          Minutes past the hour (0-59).
- *  \param second          Seconds past the minute (0-59).
- *  \param milliseconds    Milliseconds past the second (0-999).
+ *  \param lunation Lunation number as returned by CDT_LunationNumber()
+ *  (lunation 0 is the first new moon of 2000).
  *
- *  \return The elapsed time since midnight in milliseconds.
+ *  \return The Julian date (GMT) of the \a lunation's new moon.
  *
- *  \sa CDT_DecimalDay(), CDT_DecimalHour().
+ *  \sa CDT_NewMoonGMT().
  */
 
-int CDT_MillisecondOfDay( int hour, int minute, int second, int millisecond )
+double CDT_LunationGMT( int lunation )
 {
-    return( millisecond + 1000 * second + 60000 * minute + 3600000 * hour );
+    double t_new_moon, b_moon;
+
+    t_new_moon = ( lunation - D0 ) / D1;
+
+    /* Improve the estimate */
+    CDT_ImproveMoon( &t_new_moon, &b_moon );
+    CDT_ImproveMoon( &t_new_moon, &b_moon );
+
+    /* Greenwich time of new moon for this lunation paeriod */
+    return ( 36525.0 * t_new_moon + 51544.5 + 2400000.5 );
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \brief Determines low precision lunar coordinates (approximately 1').
- *
- *  From Montenbruch and Pfleger, page 38.
+/*! \brief Determines the lunation number of the \a period \eth new moon of
+ *  the \a year.
+ *
+ *  \param year Julian-Gregorian calendar year (-4712 or later).
+ *  \param period New moon of the \a year (1 == first new moon).
+ *
+ *  \return Lunation number, as used by CDT_NewMoonGMT() and
+ *  CDT_LunationGMT().
+ */
+
+int CDT_LunationNumber( int year, int period )
+{
+    return( (int) (D1 * ( year - 2000 ) / 100 ) + period );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the milliseconds elapsed since midnight.
+ *
+ *  \param hour            Hours past midnight (0-23).
+ *  \param minute          Minutes past the hour (0-59).
+ *  \param second          Seconds past the minute (0-59).
+ *  \param milliseconds    Milliseconds past the second (0-999).
+ *
+ *  \return The elapsed time since midnight in milliseconds.
+ *
+ *  \sa CDT_DecimalDay(), CDT_DecimalHour().
+ */
+
+int CDT_MillisecondOfDay( int hour, int minute, int second, int millisecond )
+{
+    return( millisecond + 1000 * second + 60000 * minute + 3600000 * hour );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the time of day from the milliseconds elapsed since
+ *  midnight.
+ *
+ *  This is the integer inverse of CDT_MillisecondOfDay().
+ *
+ *  \param ms              Milliseconds since midnight (0-86399999).
+ *  \param *hour           Returned hours past midnight (0-23).
+ *  \param *minute         Returned minutes past the hour (0-59).
+ *  \param *second         Returned seconds past the minute (0-59).
+ *  \param *millisecond    Returned milliseconds past the second (0-999).
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_MillisecondOfDay().
+ */
+
+void CDT_MillisecondTime( int ms, int *hour, int *minute, int *second,
+        int *millisecond )
+{
+    *hour = ms / 3600000;
+    *minute = ( ms / 60000 ) % 60;
+    *second = ( ms / 1000 ) % 60;
+    *millisecond = ms % 1000;
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines low precision lunar coordinates (approximately 1').
+ *
+ *  From Montenbruch and Pfleger, page 38.
  *
  *  \param t        Time in Julian centuries since J2000 (t = (jd - 2451545)
  *                  / 36526).
@@ -781,7 +1261,9 @@ static void CDT_MiniMoon( double t, double *ra, double *dec )
     z = sineps * v + coseps * w;
     rho = sqrt(1.0 - z*z);
     *dec = (360.0/p2) * atan(z/rho);
-    *ra  = (48.0/p2) * atan(y/(x+rho));
+    /* Same as M&P's half-angle (48/p2) * atan(y/(x+rho)), but without its
+       cancellation near 12h, where the moon's y and x+rho both vanish */
+    *ra  = (24.0/p2) * atan2(y, x);
     if ( *ra < 0.0 )
     {
         *ra += 24.0;
@@ -895,6 +1377,242 @@ const char *CDT_MonthName( int month )
     return( "Bad month index" );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the lunar ephemeris for each of an array of dates.
+ *
+ *  Convenience routine that calls CDT_MoonEphemerisInit() for each of the
+ *  \a n dates, so a night of timesteps can be prepared up front and reused
+ *  for every site.
+ *
+ *  \param n            Number of dates.
+ *  \param jdate        Array of \a n Julian date-times.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param eph          Returned array of \a n lunar ephemerides.
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_MoonEphemerisArray( int n, const double *jdate, double gmtDiff,
+        struct CDT_MoonEphemeris *eph )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_MoonEphemerisInit( &eph[i], jdate[i], gmtDiff );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the lunar ephemeris for a date.
+ *
+ *  The moon's right ascension and declination (from CDT_MiniMoon()), the
+ *  Greenwich mean sidereal time, and the illuminated fraction of the moon's
+ *  disk depend only upon the date, so they are stored in \a eph for reuse
+ *  by CDT_MoonPositionEph().
+ *
+ *  The illuminated fraction is (1 - cos(E)) / 2, where E is the geocentric
+ *  elongation of the moon from the sun (from CDT_MiniSun()).  This ignores
+ *  the small difference between the elongation and the supplement of the
+ *  phase angle, and is good to about 0.01.
+ *
+ *  \param eph          Pointer to the ephemeris to initialize.
+ *  \param jdate        Julian date-time.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *
+ *  \return The ephemeris is returned in \a eph.  The function itself returns
+ *  nothing.
+ */
+
+void CDT_MoonEphemerisInit( struct CDT_MoonEphemeris *eph, double jdate,
+        double gmtDiff )
+{
+    double t, sunRa, sunDec, cosElong;
+
+    /* Modified Julian date adjusted for GMT difference */
+    eph->mjd = jdate - 2400000.5 - ( gmtDiff / 24. );
+
+    /* Moon declination and right ascension */
+    t = (eph->mjd - 51544.5) / 36525.0;
+    CDT_MiniMoon( t, &eph->ra, &eph->dec );
+    eph->sinDec = sin( Radians * eph->dec );
+    eph->cosDec = cos( Radians * eph->dec );
+
+    /* Greenwich mean sidereal time */
+    eph->gmst = CDT_GreenwichSiderealTime( eph->mjd );
+
+    /* Illuminated fraction from the moon-sun elongation */
+    CDT_MiniSun( t, &sunRa, &sunDec );
+    cosElong = sn( sunDec ) * eph->sinDec
+             + cs( sunDec ) * eph->cosDec * cs( 15.0 * ( sunRa - eph->ra ) );
+    eph->fraction = 0.5 * ( 1.0 - cosElong );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the illuminated fraction of the moon's disk.
+ *
+ *  \param jdate        Julian date-time.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *
+ *  \return Illuminated fraction of the moon's disk [0..1], where 0 is new
+ *  moon and 1 is full moon.
+ *
+ *  \sa CDT_MoonEphemerisInit().
+ */
+
+double CDT_MoonIllumination( double jdate, double gmtDiff )
+{
+    struct CDT_MoonEphemeris eph;
+
+    CDT_MoonEphemerisInit( &eph, jdate, gmtDiff );
+    return( eph.fraction );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the moon in the sky.
+ *
+ *  The position is geocentric (no correction for the moon's parallax),
+ *  consistent with the moon's altitude used by CDT_RiseSet().
+ *
+ *  \param jdate        Julian date-time.
+ *  \param lon          Observer's longitude (west of GMT is positive).
+ *  \param lat          Observer's latitude in degrees.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param *altitude    Returned moon altitude in degrees from horizon.
+ *  \param *azimuth     Returned moon azimuth in degrees clockwise from north.
+ *
+ *  \return Returns the moon \a altitude and \a azimuth in the passed
+ *  arguments. The function returns nothing.
+ *
+ *  \sa CDT_MoonIllumination(), CDT_SunPosition().
+ */
+
+void CDT_MoonPosition( double jdate, double lon, double lat,
+        double gmtDiff, double *altitude, double *azimuth )
+{
+    struct CDT_MoonEphemeris eph;
+
+    CDT_MoonEphemerisInit( &eph, jdate, gmtDiff );
+    CDT_MoonPositionEph( &eph, lon, lat, altitude, azimuth );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the moon in the sky from a precomputed
+ *  lunar ephemeris.
+ *
+ *  \param eph          Pointer to a lunar ephemeris from
+ *                      CDT_MoonEphemerisInit().
+ *  \param lon          Observer's longitude (west of GMT is positive).
+ *  \param lat          Observer's latitude in degrees.
+ *  \param *altitude    Returned moon altitude in degrees from horizon.
+ *  \param *azimuth     Returned moon azimuth in degrees clockwise from north.
+ *
+ *  \return Returns the moon \a altitude and \a azimuth in the passed
+ *  arguments. The function returns nothing.
+ *
+ *  \sa CDT_MoonPosition(), CDT_MoonPositionEphArray().
+ */
+
+void CDT_MoonPositionEph( const struct CDT_MoonEphemeris *eph, double lon,
+        double lat, double *altitude, double *azimuth )
+{
+    CDT_SkyPosition( eph->gmst, eph->ra, eph->sinDec, eph->cosDec, lon, lat,
+        altitude, azimuth );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the moon in the sky for an array of
+ *  sites sharing a single precomputed lunar ephemeris.
+ *
+ *  \param eph          Pointer to a lunar ephemeris from
+ *                      CDT_MoonEphemerisInit().
+ *  \param n            Number of sites.
+ *  \param lon          Array of observer longitudes (west of GMT is positive).
+ *  \param lat          Array of observer latitudes in degrees.
+ *  \param altitude     Returned array of moon altitudes in degrees.
+ *  \param azimuth      Returned array of moon azimuths in degrees clockwise
+ *                      from north.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_MoonPositionEph().
+ */
+
+void CDT_MoonPositionEphArray( const struct CDT_MoonEphemeris *eph, int n,
+        const double *lon, const double *lat, double *altitude,
+        double *azimuth )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_MoonPositionEph( eph, lon[i], lat[i], &altitude[i], &azimuth[i] );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the moon for every combination of an
+ *  array of precomputed lunar ephemerides and an array of sites.
+ *
+ *  Each lunar ephemeris (from CDT_MoonEphemerisArray()) is shared by all the
+ *  sites, and the sine and cosine of each site's latitude are computed once
+ *  and shared by all the timesteps, so only the hour angle and altitude
+ *  remain in the inner loop.  Sites are taken in blocks of
+ *  #CDT_GridBlock whose terms fit in a small local array; within a block
+ *  the timesteps are the outer loop and the sites the inner loop, so the
+ *  results are stored contiguously.  The illuminated fraction for timestep
+ *  \a i is eph[i].fraction.
+ *
+ *  \param eph          Array of \a nTimes lunar ephemerides.
+ *  \param nTimes       Number of timesteps.
+ *  \param nSites       Number of sites.
+ *  \param lon          Array of \a nSites observer longitudes (west of GMT is
+ *                      positive).
+ *  \param lat          Array of \a nSites observer latitudes in degrees.
+ *  \param altitude     Returned array of \a nTimes * \a nSites moon altitudes
+ *                      in degrees, with the site index varying fastest.
+ *  \param azimuth      Returned array of \a nTimes * \a nSites moon azimuths
+ *                      in degrees clockwise from north, or NULL if not
+ *                      wanted.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_MoonPositionEph(), CDT_MoonEphemerisArray().
+ */
+
+void CDT_MoonPositionGrid( const struct CDT_MoonEphemeris *eph, int nTimes,
+        int nSites, const double *lon, const double *lat, double *altitude,
+        double *azimuth )
+{
+    double lonHours[CDT_GridBlock], sinLat[CDT_GridBlock];
+    double cosLat[CDT_GridBlock];
+    ptrdiff_t offset;
+    int i, j, j0, n;
+
+    for ( j0 = 0; j0 < nSites; j0 += CDT_GridBlock )
+    {
+        /* Site trigonometry is shared by all timesteps */
+        n = ( nSites - j0 < CDT_GridBlock ) ? nSites - j0 : CDT_GridBlock;
+        for ( j = 0; j < n; j++ )
+        {
+            lonHours[j] = lon[j0+j] / 15.0;
+            sinLat[j] = sin( Radians * lat[j0+j] );
+            cosLat[j] = cos( Radians * lat[j0+j] );
+        }
+        for ( i = 0; i < nTimes; i++ )
+        {
+            offset = (ptrdiff_t) i * nSites + j0;
+            CDT_SkyPositionArray( eph[i].gmst, eph[i].ra, eph[i].sinDec,
+                eph[i].cosDec, n, lonHours, sinLat, cosLat,
+                altitude + offset, ( azimuth ) ? azimuth + offset : 0 );
+        }
+    }
+    return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the GMT time of the \a period \eth new moon for the \a
  *  year.
@@ -910,19 +1628,7 @@ const char *CDT_MonthName( int month )
 
 double CDT_NewMoonGMT( int year, int period )
 {
-    double t_new_moon, b_moon;
-    int lunation;
-
-    /* Derive lunation number */
-    lunation = (int) (D1 * ( year - 2000 ) / 100 ) + period;
-    t_new_moon = ( lunation - D0 ) / D1;
-
-    /* Improve the estimate */
-    CDT_ImproveMoon( &t_new_moon, &b_moon );
-    CDT_ImproveMoon( &t_new_moon, &b_moon );
-
-    /* Greenwich time of new moon for this lunation paeriod */
-    return ( 36525.0 * t_new_moon + 51544.5 + 2400000.5 );
+    return( CDT_LunationGMT( CDT_LunationNumber( year, period ) ) );
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1025,187 +1731,367 @@ int CDT_QuadraticRoots(
 int CDT_RiseSet( int event, double jdate, double lon, double lat,
             double gmtDiff, double *hours )
 {
-    double amjd, sinh0;
-    double y_minus, y_0, y_plus;
-    double xe, ye, zero1, zero2, utset, utrise, sphi, cphi, hour;
-    int doRise, doSet, above, rise, sett, nz, flag, jd;
+    double amjd, sphi, cphi;
+    int jd;
 
     /* Strip time from the Julian date. */
     jd = (int) ( jdate - 2400000.5 );
     /* Convert to modified JD adjusted for time zone difference to GMT */
     amjd = (double) jd - gmtDiff / 24.;
 
-    /* Determine the parameters for this type of event */
-    doRise = 0;
-    doSet = 0;
-    flag = CDT_None;
-    switch ( event )
-    {
-        /* Sunrise at h = -50' */
-        case CDT_SunRise:
-            sinh0 = sn( -50.0/60.0 );
-            doRise = 1;
-            break;
-        case CDT_SunSet:
-            sinh0 = sn( -50.0/60.0 );
-            doSet = 1;
-            break;
-        /* Moonrise at h = +8' */
-        case CDT_MoonRise:
-            sinh0 = sn( 8.0/60.0 );
-            doRise = 1;
-            break;
-        case CDT_MoonSet:
-            sinh0 = sn( 8.0/60.0 );
-            doSet = 1;
-            break;
-        /* Civil twilight occurs at -6 degrees */
-        case CDT_CivilDawn:
-            sinh0 = sn( -6.0 );
-            doRise = 1;
-            break;
-        case CDT_CivilDusk:
-            sinh0 = sn( -6.0 );
-            doSet = 1;
-            break;
-        /* Nautical twilight occurs at -12 degrees */
-        case CDT_NauticalDawn:
-            sinh0 = sn( -12.0 );
-            doRise = 1;
-            break;
-        case CDT_NauticalDusk:
-            sinh0 = sn( -12.0 );
-            doSet = 1;
-            break;
-        /* Astronomical twilight occurs at -18 degrees */
-        case CDT_AstronomicalDawn:
-            sinh0 = sn( -18.0 );
-            doRise = 1;
-            break;
-        case CDT_AstronomicalDusk:
-            sinh0 = sn( -18.0 );
-            doSet = 1;
-            break;
-        default:
-            return( flag );
-    }
-
     /* Start */
     sphi = sn( lat );
     cphi = cs( lat );
-    hour = 1.0;
-    y_minus = CDT_SineAltitude( event, amjd, hour-1.0, lon, cphi, sphi) - sinh0;
-    above = (y_minus > 0.);
-    rise = 0;
-    sett = 0;
+    return( CDT_RiseSetScan( event, 0, amjd, lon, cphi, sphi, hours ) );
+}
 
-    /* Loop over search intervals from [0h-2h] to [22h-24h] */
-    do
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the times of all the daily rise, set, and twilight
+ *  events at an observer's position in a single pass.
+ *
+ *  CDT_RiseSet() evaluates up to 25 hourly solar (or lunar) altitudes for
+ *  each event it is asked for.  This function evaluates the solar altitude
+ *  curve for the day just once, and the lunar curve at most once, and then
+ *  extracts every threshold crossing from those samples with
+ *  CDT_RiseSetSamples().  The results are identical to calling CDT_RiseSet()
+ *  for each event.
+ *
+ *  \param jdate    Julian date as determined by CDT_JulianDate().
+ *  \param lon      Decimal degrees longitude (west GMT is positive).
+ *  \param lat      Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff  Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param moon     If non-zero, the #CDT_MoonRise and #CDT_MoonSet events
+ *                  are also determined.
+ *  \param hours    Returned array indexed by #CDT_Event of the decimal hours
+ *                  of each event.  Must have at least #CDT_Spring elements.
+ *                  Elements for events that do not occur are set to zero.
+ *  \param flags    Returned array indexed by #CDT_Event of the #CDT_Flag
+ *                  result of each event, as returned by CDT_RiseSet().  Must
+ *                  have at least #CDT_Spring elements.  Elements #CDT_User,
+ *                  #CDT_System, and (if \a moon is zero) #CDT_MoonRise and
+ *                  #CDT_MoonSet are set to #CDT_None.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_RiseSet(), CDT_RiseSetSamples(), CDT_SineAltitudeSamples().
+ */
+
+void CDT_RiseSetAll( double jdate, double lon, double lat, double gmtDiff,
+            int moon, double *hours, int *flags )
+{
+    double sunAlt[25], moonAlt[25];
+
+    /* Evaluate each body's altitude curve just once */
+    CDT_SineAltitudeSamples( CDT_SunRise, jdate, lon, lat, gmtDiff, sunAlt );
+    if ( moon )
     {
-        y_0    = CDT_SineAltitude( event, amjd, hour,     lon, cphi, sphi )
-               - sinh0;
-        y_plus = CDT_SineAltitude( event, amjd, hour+1.0, lon, cphi, sphi )
-               - sinh0;
-        nz = CDT_QuadraticRoots( y_minus, y_0, y_plus, &xe, &ye, &zero1, &zero2 );
-        if ( nz == 0 )
-        {
-        }
-        else if ( nz == 1 )
-        {
-            if ( y_minus < 0.0 )
-            {
-                utrise = hour + zero1;
-                rise = 1;
-            }
-            else
-            {
-                utset = hour + zero1;
-                sett = 1;
-            }
-        }
-        else if ( nz == 2 )
-        {
-            if ( ye < 0.0 )
-            {
-                utrise = hour + zero2;
-                utset = hour + zero1;
-            }
-            else
-            {
-                utrise = hour + zero1;
-                utset = hour + zero2;
-            }
-            rise = 1;
-            sett = 1;
-        }
-        if ( rise && sett )
-        {
-            break;
-        }
-        /* Prepare for next interval */
-        y_minus = y_plus;
-        hour += 2.0;
-    } while ( hour < 24.5 );
+        CDT_SineAltitudeSamples( CDT_MoonRise, jdate, lon, lat, gmtDiff,
+            moonAlt );
+    }
 
-    /* Store results */
-    if ( rise || sett )
+    /* Extract every crossing */
+    CDT_RiseSetAllSamples( sunAlt, moon ? moonAlt : 0, hours, flags );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the times of all the daily rise, set, and twilight
+ *  events from a day's precomputed altitude samples.
+ *
+ *  This is the extraction step of CDT_RiseSetAll(), for callers such as the
+ *  Almanac class that fill (or carry forward) their own altitude curves.
+ *
+ *  \param sunAlt   Array of 25 sine solar altitudes at local hours 0 through
+ *                  24, as filled by CDT_SineAltitudeSamples().
+ *  \param moonAlt  Array of 25 sine lunar altitudes, or NULL if the
+ *                  #CDT_MoonRise and #CDT_MoonSet events are not wanted.
+ *  \param hours    Returned array indexed by #CDT_Event of the decimal hours
+ *                  of each event.  Must have at least #CDT_Spring elements.
+ *                  Elements for events that do not occur are set to zero.
+ *  \param flags    Returned array indexed by #CDT_Event of the #CDT_Flag
+ *                  result of each event, as returned by CDT_RiseSet().  Must
+ *                  have at least #CDT_Spring elements.  Elements #CDT_User,
+ *                  #CDT_System, and (if \a moonAlt is NULL) #CDT_MoonRise and
+ *                  #CDT_MoonSet are set to #CDT_None.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_RiseSetAll(), CDT_RiseSetSamples().
+ */
+
+void CDT_RiseSetAllSamples( const double *sunAlt, const double *moonAlt,
+            double *hours, int *flags )
+{
+    int event;
+
+    for ( event = CDT_User; event <= CDT_AstronomicalDusk; event++ )
     {
-        if ( doRise )
+        hours[event] = 0.;
+        flags[event] = CDT_None;
+        if ( event == CDT_MoonRise || event == CDT_MoonSet )
         {
-            if ( rise )
-            {
-                *hours = utrise;
-                flag = CDT_Rises;
-            }
-            else
+            if ( moonAlt )
             {
-                flag = CDT_NeverRises;
+                flags[event] = CDT_RiseSetSamples( event, moonAlt,
+                    &hours[event] );
             }
         }
-        else if ( doSet )
+        else if ( event >= CDT_SunRise )
         {
-            if ( sett )
-            {
-                *hours = utset;
-                flag = CDT_Sets;
-            }
-            else
-            {
-                flag = CDT_NeverSets;
-            }
+            flags[event] = CDT_RiseSetSamples( event, sunAlt, &hours[event] );
         }
     }
-    /* No rise or set occurred */
-    else
-    {
-        /* If above horizon, then always visible or always light */
-        if ( above )
-        {
-            if ( event == CDT_SunRise || event == CDT_SunSet
-             || event == CDT_MoonRise || event == CDT_MoonSet )
-            {
-                flag = CDT_Visible;
-            }
-            else
-            {
-                flag = CDT_Light;
-            }
-        }
-        /* If below horizon, then always invisible or always dark */
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the rise or set time of the sun, dawn, or dusk by
+ *  Newton iteration from the analytic hour angle.
+ *
+ *  CDT_RiseSet() scans up to 25 hourly altitudes for each event.  This
+ *  function instead evaluates the sun's declination and hour angle once,
+ *  at local noon, and seeds the event time from the hour angle H0 at which
+ *  the sun crosses the event altitude h0,
+ *
+ *      cos(H0) = ( sin(h0) - sin(lat) sin(dec) ) / ( cos(lat) cos(dec) ),
+ *
+ *  then refines it with one Newton step and secant steps on
+ *  CDT_SineAltitude().  An event typically takes 3 or 4 ephemeris
+ *  evaluations instead of 15 to 25.
+ *
+ *  #CDT_MoonRise and #CDT_MoonSet are always passed to the CDT_RiseSet()
+ *  scan, since the moon may rise or set twice, or not at all, on any date.
+ *  Sun, dawn, and dusk events also fall back to the scan whenever the seed
+ *  cannot be trusted: near the poles (where |cos(H0)| is near or above 1,
+ *  so the sun may stay up or down all day or cross the threshold twice),
+ *  when the event falls within an hour of either local midnight (where it
+ *  may occur zero or two times on the date), and when the iteration does
+ *  not converge.  Elsewhere the sun crosses the threshold once on the
+ *  date, so the #CDT_Flag result is the same as CDT_RiseSet()'s.
+ *
+ *  Returned times are the root of the CDT_MiniSun() altitude curve to
+ *  within 0.01 seconds, whereas CDT_RiseSet()'s interpolation of hourly
+ *  samples is typically 10 and at most about 20 seconds from that root.
+ *
+ *  \param event    One of the #CDT_Event rise, set, dawn, or dusk values
+ *                  accepted by CDT_RiseSet().
+ *  \param jdate    Julian date as determined by CDT_JulianDate().
+ *  \param lon      Decimal degrees longitude (west GMT is positive).
+ *  \param lat      Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff  Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param *hours   Returned decimals hours of the event.
+ *
+ *  \return One of the #CDT_Flag values documented for CDT_RiseSet().
+ *
+ *  \sa CDT_RiseSet(), CDT_SineAltitude().
+ */
+
+int CDT_RiseSetNewton( int event, double jdate, double lon, double lat,
+            double gmtDiff, double *hours )
+{
+    double amjd, sphi, cphi, sinh0, ra, dec, cosH0, tau, hour;
+    double y, y0, h0, slope, dh;
+    int jd, dir, iter;
+
+    /* Modified JD of local midnight adjusted to GMT, as in CDT_RiseSet() */
+    jd = (int) ( jdate - 2400000.5 );
+    amjd = (double) jd - gmtDiff / 24.;
+    sphi = sn( lat );
+    cphi = cs( lat );
+    if ( ( dir = CDT_RiseSetThreshold( event, &sinh0 ) ) == 0 )
+    {
+        return( CDT_None );
+    }
+    /* The moon may rise or set twice, or not at all, on any date */
+    if ( event == CDT_MoonRise || event == CDT_MoonSet )
+    {
+        return( CDT_RiseSet( event, jdate, lon, lat, gmtDiff, hours ) );
+    }
+
+    /* Sun position and hour angle at local noon */
+    CDT_MiniSun( ( amjd + 0.5 - 51544.5 ) / 36525.0, &ra, &dec );
+    cosH0 = ( sinh0 - sphi * sn( dec ) ) / ( cphi * cs( dec ) );
+    if ( cphi < 1.e-6 || fabs( cosH0 ) > 0.98 )
+    {
+        return( CDT_RiseSet( event, jdate, lon, lat, gmtDiff, hours ) );
+    }
+    tau = 15.0 * ( CDT_LocalMeanSiderealTime( amjd + 0.5, lon ) - ra );
+    tau -= 360.0 * floor( ( tau + 180.0 ) / 360.0 );
+
+    /* Seed from the transit nearest noon and the analytic hour angle */
+    hour = 12.0 - ( tau + dir * acos( cosH0 ) / Radians ) / 15.0;
+
+    /* One Newton step with the analytic slope, then secant steps */
+    h0 = y0 = 0.;
+    for ( iter = 0; iter < 6; iter++ )
+    {
+        if ( hour < 1.0 || hour > 23.0 )
+        {
+            break;
+        }
+        y = CDT_SineAltitudeBody<0>( amjd, hour, lon, cphi, sphi ) - sinh0;
+        if ( iter == 0 )
+        {
+            tau = 15.0 * ( CDT_LocalMeanSiderealTime( amjd + hour / 24.0, lon )
+                - ra );
+            slope = -cphi * cs( dec ) * sn( tau ) * Radians * 15.0;
+        }
         else
         {
-            if ( event == CDT_SunRise || event == CDT_SunSet
-             || event == CDT_MoonRise || event == CDT_MoonSet )
-            {
-                flag = CDT_Invisible;
-            }
-            else
+            slope = ( y - y0 ) / ( hour - h0 );
+        }
+        if ( slope == 0. || slope * dir < 0. )
+        {
+            break;
+        }
+        dh = -y / slope;
+        h0 = hour;
+        y0 = y;
+        hour += dh;
+        if ( fabs( dh ) < 3.e-5 )
+        {
+            if ( hour < 1.0 || hour > 23.0 )
             {
-                flag = CDT_Dark;
+                break;
             }
+            *hours = hour;
+            return( ( dir > 0 ) ? CDT_Rises : CDT_Sets );
         }
     }
-    return( flag );
+    return( CDT_RiseSet( event, jdate, lon, lat, gmtDiff, hours ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the rise or set time of the sun, moon, dawn, or dusk
+ *  from a day of precomputed hourly altitudes.
+ *
+ *  Same as CDT_RiseSet() except that the 25 hourly sines of the altitude
+ *  are supplied by the caller (usually from CDT_SineAltitudeSamples()), so
+ *  one altitude curve can serve several events.
+ *
+ *  \param event    One of the #CDT_Event rise, set, dawn, or dusk values
+ *                  accepted by CDT_RiseSet().
+ *  \param sinAlt   Array of 25 sines of the sun (or, for #CDT_MoonRise and
+ *                  #CDT_MoonSet, the moon) altitude at local hours 0
+ *                  through 24.
+ *  \param *hours   Returned decimals hours of the event.
+ *
+ *  \return One of the #CDT_Flag values documented for CDT_RiseSet().
+ *
+ *  \sa CDT_RiseSet(), CDT_SineAltitudeSamples().
+ */
+
+int CDT_RiseSetSamples( int event, const double *sinAlt, double *hours )
+{
+    return( CDT_RiseSetScan( event, sinAlt, 0., 0., 0., 0., hours ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Scans a day of hourly altitudes for the rise or set time of the
+ *  sun, moon, dawn, or dusk.
+ *
+ *  Dispatches once on \a event (and on whether \a sinAlt is given) to the
+ *  CDT_RiseSetKernel() instantiation for that event, so the search loop
+ *  itself never branches on the event or the body.
+ *
+ *  \param event One of the #CDT_Event rise, set, dawn, or dusk enumerations.
+ *  \param sinAlt Array of 25 sines of the altitude at hours 0 through 24,
+ *  or NULL to evaluate them on demand.
+ *  \param amjd Modified Julian date of local midnight adjusted to GMT
+ *  (only used if \a sinAlt is NULL).
+ *  \param lon Longitude in degrees (only used if \a sinAlt is NULL).
+ *  \param cphi Cosine of the latitude (only used if \a sinAlt is NULL).
+ *  \param sphi Sine of the latitude (only used if \a sinAlt is NULL).
+ *  \param *hours Returned decimals hours of the event.
+ *
+ *  \return One of the #CDT_Flag values documented for CDT_RiseSet().
+ *
+ *  \internal
+ */
+
+static int CDT_RiseSetScan( int event, const double *sinAlt, double amjd,
+            double lon, double cphi, double sphi, double *hours )
+{
+    switch ( event )
+    {
+        case CDT_SunRise:
+            return( CDT_RiseSetDispatch<CDT_SunRise>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_SunSet:
+            return( CDT_RiseSetDispatch<CDT_SunSet>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_MoonRise:
+            return( CDT_RiseSetDispatch<CDT_MoonRise>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_MoonSet:
+            return( CDT_RiseSetDispatch<CDT_MoonSet>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_CivilDawn:
+            return( CDT_RiseSetDispatch<CDT_CivilDawn>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_CivilDusk:
+            return( CDT_RiseSetDispatch<CDT_CivilDusk>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_NauticalDawn:
+            return( CDT_RiseSetDispatch<CDT_NauticalDawn>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_NauticalDusk:
+            return( CDT_RiseSetDispatch<CDT_NauticalDusk>( sinAlt, amjd, lon,
+                cphi, sphi, hours ) );
+        case CDT_AstronomicalDawn:
+            return( CDT_RiseSetDispatch<CDT_AstronomicalDawn>( sinAlt, amjd,
+                lon, cphi, sphi, hours ) );
+        case CDT_AstronomicalDusk:
+            return( CDT_RiseSetDispatch<CDT_AstronomicalDusk>( sinAlt, amjd,
+                lon, cphi, sphi, hours ) );
+    }
+    return( CDT_None );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the altitude threshold of a rise, set, dawn, or dusk
+ *  event.
+ *
+ *  The thresholds themselves are those of CDT_RiseSetEvent<>::sinh0().
+ *
+ *  \param event One of the #CDT_Event rise, set, dawn, or dusk enumerations.
+ *  \param *sinh0 Returned sine of the threshold altitude (sun and moon
+ *  rise and set at -50' and +8', twilights at -6, -12, and -18 degrees).
+ *
+ *  \return +1 for a rise or dawn, -1 for a set or dusk, or 0 if \a event is
+ *  not a rise, set, dawn, or dusk.
+ *
+ *  \internal
+ */
+
+static int CDT_RiseSetThreshold( int event, double *sinh0 )
+{
+    switch ( event )
+    {
+        case CDT_SunRise:
+            return( CDT_RiseSetEventThreshold<CDT_SunRise>( sinh0 ) );
+        case CDT_SunSet:
+            return( CDT_RiseSetEventThreshold<CDT_SunSet>( sinh0 ) );
+        case CDT_MoonRise:
+            return( CDT_RiseSetEventThreshold<CDT_MoonRise>( sinh0 ) );
+        case CDT_MoonSet:
+            return( CDT_RiseSetEventThreshold<CDT_MoonSet>( sinh0 ) );
+        case CDT_CivilDawn:
+            return( CDT_RiseSetEventThreshold<CDT_CivilDawn>( sinh0 ) );
+        case CDT_CivilDusk:
+            return( CDT_RiseSetEventThreshold<CDT_CivilDusk>( sinh0 ) );
+        case CDT_NauticalDawn:
+            return( CDT_RiseSetEventThreshold<CDT_NauticalDawn>( sinh0 ) );
+        case CDT_NauticalDusk:
+            return( CDT_RiseSetEventThreshold<CDT_NauticalDusk>( sinh0 ) );
+        case CDT_AstronomicalDawn:
+            return( CDT_RiseSetEventThreshold<CDT_AstronomicalDawn>(
+                sinh0 ) );
+        case CDT_AstronomicalDusk:
+            return( CDT_RiseSetEventThreshold<CDT_AstronomicalDusk>(
+                sinh0 ) );
+    }
+    return( 0 );
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1226,21 +2112,185 @@ int CDT_RiseSet( int event, double jdate, double lon, double lat,
 double CDT_SineAltitude( int event, double mjd0, double hour,
     double lambda, double cphi, double sphi )
 {
-    double ra, dec, mjd, t, tau;
-    mjd = mjd0 + hour/24.0;
-    t = (mjd - 51544.5) / 36525.0;
     /* Moon times */
     if ( event == CDT_MoonRise || event == CDT_MoonSet )
     {
-        CDT_MiniMoon( t, &ra, &dec );
+        return( CDT_SineAltitudeBody<1>( mjd0, hour, lambda, cphi, sphi ) );
     }
     /* Sun times */
+    return( CDT_SineAltitudeBody<0>( mjd0, hour, lambda, cphi, sphi ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the sine of the altitude of the sun from a precomputed
+ *  solar ephemeris.
+ *
+ *  Same as CDT_SineAltitude() for the sun, except the right ascension,
+ *  declination, and sidereal time are taken from \a eph rather than being
+ *  recomputed for every site.
+ *
+ *  \param eph Pointer to a solar ephemeris from CDT_SunEphemerisInit().
+ *  \param lambda Longitude in degrees (west of Greenwich is positive).
+ *  \param cphi Cosine of the latitude
+ *  \param sphi Sine of the latitude
+ *
+ *  \return Sine of the altitude of the sun.
+ *
+ *  \sa CDT_SineAltitude(), CDT_SunEphemerisInit().
+ */
+
+double CDT_SineAltitudeEph( const struct CDT_SunEphemeris *eph,
+    double lambda, double cphi, double sphi )
+{
+    double lmst, tau;
+    lmst = 24.0 * CDT_FractionalPart( (eph->gmst - lambda/15.0) / 24.0 );
+    tau = 15.0 * ( lmst - eph->ra );
+    return( sphi * eph->sinDec + cphi * eph->cosDec * cs(tau) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the sine of the altitude of the moon or sun at each
+ *  local hour 0 through 24 of a date.
+ *
+ *  These are the samples searched by CDT_RiseSet(); pass them to
+ *  CDT_RiseSetSamples() to determine several events from one curve.
+ *
+ *  \param event    One of the #CDT_Event enumerations; #CDT_MoonRise and
+ *                  #CDT_MoonSet select the moon, all others the sun.
+ *  \param jdate    Julian date as determined by CDT_JulianDate().
+ *  \param lon      Decimal degrees longitude (west GMT is positive).
+ *  \param lat      Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff  Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param sinAlt   Returned array of 25 sines of the altitude.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_RiseSetSamples().
+ */
+
+void CDT_SineAltitudeSamples( int event, double jdate, double lon,
+            double lat, double gmtDiff, double *sinAlt )
+{
+    double amjd, sphi, cphi;
+    int jd, hour;
+
+    /* Modified JD of local midnight adjusted to GMT, as in CDT_RiseSet() */
+    jd = (int) ( jdate - 2400000.5 );
+    amjd = (double) jd - gmtDiff / 24.;
+    sphi = sn( lat );
+    cphi = cs( lat );
+    if ( event == CDT_MoonRise || event == CDT_MoonSet )
+    {
+        for ( hour = 0; hour <= 24; hour++ )
+        {
+            sinAlt[hour] = CDT_SineAltitudeBody<1>( amjd, (double) hour, lon,
+                cphi, sphi );
+        }
+    }
     else
     {
-        CDT_MiniSun( t, &ra, &dec );
+        for ( hour = 0; hour <= 24; hour++ )
+        {
+            sinAlt[hour] = CDT_SineAltitudeBody<0>( amjd, (double) hour, lon,
+                cphi, sphi );
+        }
     }
-    tau = 15.0 * ( CDT_LocalMeanSiderealTime( mjd, lambda ) - ra );
-    return( sphi * sn(dec) + cphi * cs(dec) * cs(tau) );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the altitude and azimuth of a sun or moon ephemeris
+ *  for one site.
+ *
+ *  This is the shared body of CDT_SunPositionEph() and
+ *  CDT_MoonPositionEph(); both ephemerides carry the same sidereal time,
+ *  right ascension, and declination terms.
+ *
+ *  \param gmst         Greenwich mean sidereal time (hours) from the
+ *                      ephemeris.
+ *  \param ra           Right ascension (hours) from the ephemeris.
+ *  \param sinDec       Sine of the declination from the ephemeris.
+ *  \param cosDec       Cosine of the declination from the ephemeris.
+ *  \param lon          Observer's longitude (west of GMT is positive).
+ *  \param lat          Observer's latitude in degrees.
+ *  \param *altitude    Returned altitude in degrees from horizon.
+ *  \param *azimuth     Returned azimuth in degrees clockwise from north.
+ *
+ *  \internal
+ */
+
+static void CDT_SkyPosition( double gmst, double ra, double sinDec,
+        double cosDec, double lon, double lat, double *altitude,
+        double *azimuth )
+{
+    double lmst, tau, sinPhi, cosPhi, cosTau, sinAlt;
+
+    /* Azimuth */
+    lmst = 24.0 * CDT_FractionalPart( (gmst - lon/15.0) / 24.0 );
+    tau = 15.0 * ( lmst - ra );
+    if ( ( *azimuth = tau - 180. ) < 0. )
+    {
+        *azimuth += 360.;
+    }
+
+    /* Altitude */
+    sinPhi = sin( Radians * lat );
+    cosPhi = cos( Radians * lat );
+    cosTau = cos( Radians * tau );
+    sinAlt = sinPhi * sinDec + cosPhi * cosDec * cosTau;
+    *altitude = asin( sinAlt ) / Radians;
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the altitude and azimuth of a sun or moon ephemeris
+ *  for an array of sites with precomputed longitude and latitude terms.
+ *
+ *  This is the innermost kernel of CDT_SunPositionEph() and
+ *  CDT_MoonPositionEph(), for callers (such as a site registry) that keep
+ *  each site's longitude in hours and the sine and cosine of its latitude
+ *  rather than recomputing them at every timestep.  The results are
+ *  identical to those routines.
+ *
+ *  \param gmst         Greenwich mean sidereal time (hours) from the
+ *                      ephemeris.
+ *  \param ra           Right ascension (hours) from the ephemeris.
+ *  \param sinDec       Sine of the declination from the ephemeris.
+ *  \param cosDec       Cosine of the declination from the ephemeris.
+ *  \param n            Number of sites.
+ *  \param lonHours     Array of site longitudes divided by 15 (west of GMT is
+ *                      positive).
+ *  \param sinLat       Array of sines of the site latitudes.
+ *  \param cosLat       Array of cosines of the site latitudes.
+ *  \param altitude     Returned array of altitudes in degrees.
+ *  \param azimuth      Returned array of azimuths in degrees clockwise from
+ *                      north, or NULL if not wanted.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_SunPositionEph(), CDT_MoonPositionEph().
+ */
+
+void CDT_SkyPositionArray( double gmst, double ra, double sinDec,
+        double cosDec, int n, const double *lonHours, const double *sinLat,
+        const double *cosLat, double *altitude, double *azimuth )
+{
+    double lmst, tau, azm, sinAlt;
+    int i;
+
+    for ( i = 0; i < n; i++ )
+    {
+        lmst = 24.0 * CDT_FractionalPart( (gmst - lonHours[i]) / 24.0 );
+        tau = 15.0 * ( lmst - ra );
+        if ( azimuth )
+        {
+            azm = tau - 180.;
+            azimuth[i] = ( azm < 0. ) ? azm + 360. : azm;
+        }
+        sinAlt = sinLat[i] * sinDec + cosLat[i] * cosDec * cos( Radians * tau );
+        altitude[i] = asin( sinAlt ) / Radians;
+    }
+    return;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1292,6 +2342,151 @@ double CDT_SolarAngle( double slope, double aspect, double altitude,
     return( rad2Deg * asin(sunRad) );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the solar transit time, day length, maximum altitude,
+ *  and declination on a date at an observer's position.
+ *
+ *  The sun's position is evaluated just once, by CDT_MiniSun() at local
+ *  noon.  The transit is found from the hour angle at noon, assuming the
+ *  hour angle advances at the mean solar rate of 15 degrees per hour (good
+ *  to a second).  The day length is twice the hour angle at which the sun's
+ *  center crosses -50' (the #CDT_SunRise and #CDT_SunSet altitude),
+ *
+ *      cos(H0) = ( sin(-50') - sin(lat) sin(dec) ) / ( cos(lat) cos(dec) ),
+ *
+ *  and agrees with the difference of CDT_RiseSet()'s sunset and sunrise to
+ *  within a minute except within days of polar day or night.  The maximum
+ *  altitude is the geometric altitude at transit, 90 - |lat - dec|, good
+ *  to about 15 arc seconds (the change in declination between local noon
+ *  and transit).
+ *
+ *  \param jdate        Julian date as determined by CDT_JulianDate().
+ *  \param lon          Decimal degrees longitude (west GMT is positive).
+ *  \param lat          Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param *transit     Returned local decimal hours of the solar transit
+ *                      (may be outside [0..24) if \a gmtDiff is far from
+ *                      the local mean time of \a lon).
+ *  \param *dayLength   Returned hours the sun is above the horizon (0 for
+ *                      polar night, 24 for polar day).
+ *  \param *maxAltitude Returned sun altitude at transit in degrees.
+ *  \param *declination Returned sun declination at local noon in degrees.
+ *
+ *  \retval #CDT_Rises if the sun rises and sets on the date.
+ *  \retval #CDT_Visible if it is polar day and the sun never sets.
+ *  \retval #CDT_Invisible if it is polar night and the sun never rises.
+ *
+ *  \sa CDT_SolarDayArray(), CDT_RiseSet().
+ */
+
+int CDT_SolarDay( double jdate, double lon, double lat, double gmtDiff,
+        double *transit, double *dayLength, double *maxAltitude,
+        double *declination )
+{
+    double amjd, ra, dec, tau, sinh0, num, den;
+    int jd;
+
+    /* Modified JD of local midnight adjusted to GMT, as in CDT_RiseSet() */
+    jd = (int) ( jdate - 2400000.5 );
+    amjd = (double) jd - gmtDiff / 24.;
+
+    /* Sun position and hour angle at local noon */
+    CDT_MiniSun( ( amjd + 0.5 - 51544.5 ) / 36525.0, &ra, &dec );
+    tau = 15.0 * ( CDT_LocalMeanSiderealTime( amjd + 0.5, lon ) - ra );
+    tau -= 360.0 * floor( ( tau + 180.0 ) / 360.0 );
+    *transit = 12.0 - tau / 15.0;
+    *declination = dec;
+    *maxAltitude = 90.0 - fabs( lat - dec );
+
+    /* Hour angle of sunrise and sunset */
+    CDT_RiseSetThreshold( CDT_SunRise, &sinh0 );
+    num = sinh0 - sn( lat ) * sn( dec );
+    den = cs( lat ) * cs( dec );
+    if ( num >= den )
+    {
+        *dayLength = 0.;
+        return( CDT_Invisible );
+    }
+    if ( num <= -den )
+    {
+        *dayLength = 24.;
+        return( CDT_Visible );
+    }
+    *dayLength = 2.0 * acos( num / den ) / ( 15.0 * Radians );
+    return( CDT_Rises );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the solar transit time, day length, maximum altitude,
+ *  and declination for arrays of dates and observer positions.
+ *
+ *  This is the batch form of CDT_SolarDay().  Element \a i of each output
+ *  array is identical to the result of CDT_SolarDay() for element \a i of
+ *  the input arrays.
+ *
+ *  \param n            Number of elements in each array.
+ *  \param jdate        Array of Julian dates.
+ *  \param lon          Array of observer longitudes (west of GMT is positive).
+ *  \param lat          Array of observer latitudes in degrees.
+ *  \param gmtDiff      Array of local time differences from GMT
+ *                      (local=GMT+gmtDiff).
+ *  \param transit      Returned array of local decimal hours of transit.
+ *  \param dayLength    Returned array of day lengths in hours.
+ *  \param maxAltitude  Returned array of sun altitudes at transit in degrees.
+ *  \param declination  Returned array of sun declinations in degrees.
+ *  \param flags        Returned array of #CDT_Rises, #CDT_Visible, or
+ *                      #CDT_Invisible, or NULL if not wanted.
+ *
+ *  \warning The output arrays must not overlap the input arrays.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_SolarDay().
+ */
+
+void CDT_SolarDayArray( int n, const double *jdate, const double *lon,
+        const double *lat, const double *gmtDiff, double *transit,
+        double *dayLength, double *maxAltitude, double *declination,
+        int *flags )
+{
+    int i, flag;
+
+    for ( i = 0; i < n; i++ )
+    {
+        flag = CDT_SolarDay( jdate[i], lon[i], lat[i], gmtDiff[i],
+            &transit[i], &dayLength[i], &maxAltitude[i], &declination[i] );
+        if ( flags )
+        {
+            flags[i] = flag;
+        }
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief  Determines the solar incidence on the terrain slope from a
+ *  precomputed terrain normal and sun vector.
+ *
+ *  This is the dot product of the terrain \a normal and the \a sun vector,
+ *  and equals the sine of the angle returned by CDT_SolarAngle() without
+ *  any per-call trigonometry.
+ *
+ *  \param normal Pointer to a terrain normal from CDT_TerrainNormal().
+ *  \param sun Sun unit vector [east, north, up] from CDT_SunVector() or
+ *  CDT_SunVectorEph().
+ *
+ *  \return Sine of the solar angle to the slope [-1..+1].  A value of 1
+ *  indicates the sun is normal to the slope.  A negative number indicates
+ *  that the slope is shaded.
+ *
+ *  \sa CDT_SolarAngle().
+ */
+
+double CDT_SolarIncidence( const struct CDT_Normal *normal, const double *sun )
+{
+    return( normal->x * sun[0] + normal->y * sun[1] + normal->z * sun[2] );
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the proportion [0..1] of the solar radiation constant
  *  arriving at the forest floor given:
@@ -1328,11 +2523,48 @@ double CDT_SolarRadiation( double jdate, double lon, double lat, double gmtDiff,
             double slope, double aspect, double elev,
             double atmTransparency, double cloudTransmittance,
             double canopyTransmittance )
+{
+    struct CDT_SunEphemeris eph;
+
+    /* Get the sun ephemeris for this date. */
+    CDT_SunEphemerisInit( &eph, jdate, gmtDiff );
+    return( CDT_SolarRadiationEph( &eph, lon, lat, slope, aspect, elev,
+        atmTransparency, cloudTransmittance, canopyTransmittance ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the proportion [0..1] of the solar radiation constant
+ *  arriving at the forest floor from a precomputed solar ephemeris.
+ *
+ *  Same as CDT_SolarRadiation() except the sun's coordinates are taken from
+ *  \a eph, so a landscape of sites at one instant shares a single ephemeris.
+ *
+ *  \param eph Pointer to a solar ephemeris from CDT_SunEphemerisInit().
+ *  \param lon Site longitude in degrees (positive if west of Greenwich).
+ *  \param lat Site latitude in degrees (positive if north of equator).
+ *  \param slope Terrain slope in degrees.
+ *  \param aspect Terrain aspect (downslope direction in degrees clockwise
+ *  from north)
+ *  \param elev Site elevation in meters.
+ *  \param atmTransparency The atmospheric transparency coefficient ([0.6-0.8])
+ *  \param cloudTransmittance The cloud transmittance factor [0..1].
+ *  \param canopyTransmittance The canopy transmittance factor [0..1].
+ *
+ *  \return Proportion of the solar radiation constant arriving at the forest
+ *  floor [0..1].
+ *
+ *  \sa CDT_SolarRadiation(), CDT_SunEphemerisInit().
+ */
+
+double CDT_SolarRadiationEph( const struct CDT_SunEphemeris *eph,
+            double lon, double lat, double slope, double aspect, double elev,
+            double atmTransparency, double cloudTransmittance,
+            double canopyTransmittance )
 {
     double alt, azim, angle, fraction, m;
 
-    /* Get the sun position for this date. */
-    CDT_SunPosition( jdate, lon, lat, gmtDiff, &alt, &azim );
+    /* Get the sun position for this site. */
+    CDT_SunPositionEph( eph, lon, lat, &alt, &azim );
 
     /* If the sun is below the horizon, return radiation fraction of zero. */
     if ( alt <= 0.0 )
@@ -1358,6 +2590,56 @@ double CDT_SolarRadiation( double jdate, double lon, double lat, double gmtDiff,
     return( fraction );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the proportion [0..1] of the solar radiation constant
+ *  arriving at the forest floor from a precomputed terrain normal and sun
+ *  vector.
+ *
+ *  Same model as CDT_SolarRadiation(), but with all static terrain and
+ *  per-timestep sun trigonometry hoisted out by the caller.
+ *
+ *  \param sun Sun unit vector [east, north, up] from CDT_SunVector() or
+ *  CDT_SunVectorEph().
+ *  \param normal Pointer to a terrain normal from CDT_TerrainNormal().
+ *  \param elevFactor Air mass elevation factor from
+ *  CDT_AirMassElevationFactor().
+ *  \param atmTransparency The atmospheric transparency coefficient ([0.6-0.8])
+ *  \param cloudTransmittance The cloud transmittance factor [0..1].
+ *  \param canopyTransmittance The canopy transmittance factor [0..1].
+ *
+ *  \return Proportion of the solar radiation constant arriving at the forest
+ *  floor [0..1].
+ *
+ *  \sa CDT_SolarRadiation(), CDT_SolarIncidence().
+ */
+
+double CDT_SolarRadiationNormal( const double *sun,
+            const struct CDT_Normal *normal, double elevFactor,
+            double atmTransparency, double cloudTransmittance,
+            double canopyTransmittance )
+{
+    double incidence;
+
+    /* If the sun is below the horizon, return radiation fraction of zero. */
+    if ( sun[2] <= 0.0 )
+    {
+        return( 0.0 );
+    }
+
+    /* If the slope is self-shaded, return radiation fraction of zero. */
+    incidence = CDT_SolarIncidence( normal, sun );
+    if ( incidence < 0.0 )
+    {
+        return( 0.0 );
+    }
+
+    /* Proportion of sr arriving thru air mass, clouds, and canopy. */
+    return( pow( atmTransparency, elevFactor / sun[2] )
+          * cloudTransmittance
+          * canopyTransmittance
+          * incidence );
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the calendar date and time of the requested equinox or
  *  solstice.
@@ -1406,6 +2688,67 @@ double CDT_SolsticeGMT( int event, int year )
     return( a[i] + b1[i]*year + b2[i]*y*y + b3[i]*y*y*y );
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the solar ephemerides for an array of dates.
+ *
+ *  Convenience routine that calls CDT_SunEphemerisInit() for each of the
+ *  \a n dates, so a whole grid of timesteps can be prepared up front and
+ *  reused for every site.
+ *
+ *  \param n            Number of dates.
+ *  \param jdate        Array of \a n Julian date-times.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param eph          Returned array of \a n solar ephemerides.
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_SunEphemerisArray( int n, const double *jdate, double gmtDiff,
+        struct CDT_SunEphemeris *eph )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_SunEphemerisInit( &eph[i], jdate[i], gmtDiff );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the solar ephemeris for a date.
+ *
+ *  The sun's right ascension and declination (from CDT_MiniSun()) and the
+ *  Greenwich mean sidereal time depend only upon the date, so they are
+ *  stored in \a eph for reuse by the site-level routines
+ *  CDT_SunPositionEph(), CDT_SineAltitudeEph(), and CDT_SolarRadiationEph().
+ *
+ *  \param eph          Pointer to the ephemeris to initialize.
+ *  \param jdate        Julian date-time.
+ *  \param gmtDiff      Local time difference from GMT (local=GMT+gmtDiff).
+ *
+ *  \return The ephemeris is returned in \a eph.  The function itself returns
+ *  nothing.
+ */
+
+void CDT_SunEphemerisInit( struct CDT_SunEphemeris *eph, double jdate,
+        double gmtDiff )
+{
+    double t;
+
+    /* Modified Julian date adjusted for GMT difference */
+    eph->mjd = jdate - 2400000.5 - ( gmtDiff / 24. );
+
+    /* Sun declination and right ascension */
+    t = (eph->mjd - 51544.5) / 36525.0;
+    CDT_MiniSun( t, &eph->ra, &eph->dec );
+    eph->sinDec = sin( Radians * eph->dec );
+    eph->cosDec = cos( Radians * eph->dec );
+
+    /* Greenwich mean sidereal time */
+    eph->gmst = CDT_GreenwichSiderealTime( eph->mjd );
+    return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \brief Determines the position of the sun in the sky.
  *
@@ -1425,31 +2768,236 @@ double CDT_SolsticeGMT( int event, int year )
 void CDT_SunPosition( double jdate, double lon, double lat,
         double gmtDiff, double *altitude, double *azimuth )
 {
-    double mjd, ra, dec, t, tau;
-    double sinPhi, cosPhi, sinDec, cosDec, cosTau, sinAlt;
+    struct CDT_SunEphemeris eph;
 
-    /* Modified Julian date adjusted for GMT difference */
-    mjd  = jdate - 2400000.5 - ( gmtDiff / 24. );
+    /* Sun declination, right ascension, and sidereal time */
+    CDT_SunEphemerisInit( &eph, jdate, gmtDiff );
+    CDT_SunPositionEph( &eph, lon, lat, altitude, azimuth );
+    return;
+}
 
-    /* Sun declination and right ascension */
-    t = (mjd - 51544.5) / 36525.0;
-    CDT_MiniSun( t, &ra, &dec );
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the sun in the sky for arrays of dates
+ *  and observer positions.
+ *
+ *  This is the batch form of CDT_SunPosition().  Element \a i of each output
+ *  array is identical to the result of CDT_SunPosition() for element \a i of
+ *  the input arrays, but the work is done in a single tight loop over
+ *  contiguous arrays so the compiler is free to pipeline and vectorize it.
+ *
+ *  \param n            Number of elements in each array.
+ *  \param jdate        Array of Julian date-times.
+ *  \param lon          Array of observer longitudes (west of GMT is positive).
+ *  \param lat          Array of observer latitudes in degrees.
+ *  \param gmtDiff      Array of local time differences from GMT
+ *                      (local=GMT+gmtDiff).
+ *  \param altitude     Returned array of sun altitudes in degrees from
+ *                      horizon.
+ *  \param azimuth      Returned array of sun azimuths in degrees clockwise
+ *                      from north.
+ *
+ *  \warning The output arrays must not overlap the input arrays.
+ *
+ *  \return Returns the sun \a altitude and \a azimuth in the passed
+ *  arrays. The function returns nothing.
+ *
+ *  \sa CDT_SunPosition().
+ */
 
-    /* Sun azimuth */
-    tau = 15.0 * ( CDT_LocalMeanSiderealTime( mjd, lon ) - ra );
-    if ( ( *azimuth = tau - 180. ) < 0. )
+void CDT_SunPositionArray( int n, const double *jdate, const double *lon,
+        const double *lat, const double *gmtDiff, double *altitude,
+        double *azimuth )
+{
+    double mjd, ra, dec, t, tau, azm;
+    double sinPhi, cosPhi, sinDec, cosDec, cosTau;
+    int i;
+
+    for ( i = 0; i < n; i++ )
     {
-        *azimuth += 360.;
+        /* Modified Julian date adjusted for GMT difference */
+        mjd  = jdate[i] - 2400000.5 - ( gmtDiff[i] / 24. );
+
+        /* Sun declination and right ascension */
+        t = (mjd - 51544.5) / 36525.0;
+        CDT_MiniSun( t, &ra, &dec );
+
+        /* Sun azimuth */
+        tau = 15.0 * ( CDT_LocalMeanSiderealTime( mjd, lon[i] ) - ra );
+        azm = tau - 180.;
+        azimuth[i] = ( azm < 0. ) ? azm + 360. : azm;
+
+        /* Sun altitude */
+        sinPhi = sin( Radians * lat[i] );
+        cosPhi = cos( Radians * lat[i] );
+        sinDec = sin( Radians * dec );
+        cosDec = cos( Radians * dec );
+        cosTau = cos( Radians * tau );
+        altitude[i] = asin( sinPhi * sinDec + cosPhi * cosDec * cosTau )
+                    / Radians;
     }
+    return;
+}
 
-    /* Sun altitude */
-    sinPhi = sin( Radians * lat );
-    cosPhi = cos( Radians * lat );
-    sinDec = sin( Radians * dec );
-    cosDec = cos( Radians * dec );
-    cosTau = cos( Radians * tau );
-    sinAlt = sinPhi * sinDec + cosPhi * cosDec * cosTau;
-    *altitude = asin( sinAlt ) / Radians;
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the sun in the sky from a precomputed
+ *  solar ephemeris.
+ *
+ *  Only the site's hour angle and altitude are computed here; the sun's
+ *  coordinates and the sidereal time come from \a eph.
+ *
+ *  \param eph          Pointer to a solar ephemeris from
+ *                      CDT_SunEphemerisInit().
+ *  \param lon          Observer's longitude (west of GMT is positive).
+ *  \param lat          Observer's latitude in degrees.
+ *  \param *altitude    Returned sun altitude in degrees from horizon.
+ *  \param *azimuth     Returned sun azimuth in degrees clockwise from north.
+ *
+ *  \return Returns the sun \a altitude and \a azimuth in the passed
+ *  arguments. The function returns nothing.
+ *
+ *  \sa CDT_SunPosition(), CDT_SunPositionEphArray().
+ */
+
+void CDT_SunPositionEph( const struct CDT_SunEphemeris *eph, double lon,
+        double lat, double *altitude, double *azimuth )
+{
+    CDT_SkyPosition( eph->gmst, eph->ra, eph->sinDec, eph->cosDec, lon, lat,
+        altitude, azimuth );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the position of the sun in the sky for an array of
+ *  sites sharing a single precomputed solar ephemeris.
+ *
+ *  This is the site-level kernel for rasters and station lists evaluated at
+ *  one instant.
+ *
+ *  \param eph          Pointer to a solar ephemeris from
+ *                      CDT_SunEphemerisInit().
+ *  \param n            Number of sites.
+ *  \param lon          Array of observer longitudes (west of GMT is positive).
+ *  \param lat          Array of observer latitudes in degrees.
+ *  \param altitude     Returned array of sun altitudes in degrees.
+ *  \param azimuth      Returned array of sun azimuths in degrees clockwise
+ *                      from north.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_SunPositionEph().
+ */
+
+void CDT_SunPositionEphArray( const struct CDT_SunEphemeris *eph, int n,
+        const double *lon, const double *lat, double *altitude,
+        double *azimuth )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_SunPositionEph( eph, lon[i], lat[i], &altitude[i], &azimuth[i] );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the sun unit vector from its altitude and azimuth.
+ *
+ *  \param altitude     Sun altitude in degrees from horizon.
+ *  \param azimuth      Sun azimuth in degrees clockwise from north.
+ *  \param sun          Returned sun unit vector [east, north, up].
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_SunPosition(), CDT_SolarIncidence().
+ */
+
+void CDT_SunVector( double altitude, double azimuth, double *sun )
+{
+    double cosAlt = cos( Radians * altitude );
+    sun[0] = cosAlt * sin( Radians * azimuth );
+    sun[1] = cosAlt * cos( Radians * azimuth );
+    sun[2] = sin( Radians * altitude );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the sun unit vector for a site from a precomputed solar
+ *  ephemeris.
+ *
+ *  Equivalent to CDT_SunPositionEph() followed by CDT_SunVector(), but the
+ *  vector is built directly from the hour angle and the sine of the altitude
+ *  without the intermediate asin() and degree conversions.
+ *
+ *  \param eph          Pointer to a solar ephemeris from
+ *                      CDT_SunEphemerisInit().
+ *  \param lon          Observer's longitude (west of GMT is positive).
+ *  \param lat          Observer's latitude in degrees.
+ *  \param sun          Returned sun unit vector [east, north, up].
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_SunVectorEph( const struct CDT_SunEphemeris *eph, double lon,
+        double lat, double *sun )
+{
+    double lmst, tau, sinAlt, cosAlt;
+
+    /* Hour angle; the azimuth is (tau - 180) as in CDT_SunPositionEph(). */
+    lmst = 24.0 * CDT_FractionalPart( (eph->gmst - lon/15.0) / 24.0 );
+    tau = Radians * 15.0 * ( lmst - eph->ra );
+    sinAlt = sn( lat ) * eph->sinDec + cs( lat ) * eph->cosDec * cos( tau );
+    cosAlt = sqrt( 1.0 - sinAlt * sinAlt );
+    sun[0] = -cosAlt * sin( tau );
+    sun[1] = -cosAlt * cos( tau );
+    sun[2] = sinAlt;
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the terrain unit normal from its slope and aspect.
+ *
+ *  \param slope Terrain slope in degrees.
+ *  \param aspect Terrain aspect; downslope direction in degrees clockwise
+ *  from north.
+ *  \param normal Returned terrain unit normal [east, north, up].
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_SolarIncidence(), CDT_TerrainNormalArray().
+ */
+
+void CDT_TerrainNormal( double slope, double aspect, struct CDT_Normal *normal )
+{
+    double sinSlp = sn( slope );
+    normal->x = (float) ( sinSlp * sn( aspect ) );
+    normal->y = (float) ( sinSlp * cs( aspect ) );
+    normal->z = (float) cs( slope );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the terrain unit normals for arrays of slopes and
+ *  aspects.
+ *
+ *  \param n Number of elements in each array.
+ *  \param slope Array of terrain slopes in degrees.
+ *  \param aspect Array of terrain aspects; downslope direction in degrees
+ *  clockwise from north.
+ *  \param normal Returned array of terrain unit normals.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_TerrainNormal().
+ */
+
+void CDT_TerrainNormalArray( int n, const double *slope, const double *aspect,
+        struct CDT_Normal *normal )
+{
+    int i;
+    for ( i = 0; i < n; i++ )
+    {
+        CDT_TerrainNormal( slope[i], aspect[i], &normal[i] );
+    }
     return;
 }
 
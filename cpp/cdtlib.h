@@ -82,13 +82,81 @@ enum CDT_Flag
     CDT_Dark               = 18  /*!< Indicates the day has continuous darkness. */
 };
 
+/*! \struct CDT_SunEphemeris
+    \brief Solar ephemeris for a single instant.
+
+    The sun's right ascension, declination, and the Greenwich mean sidereal
+    time depend only upon the time, so they are computed once per timestep by
+    CDT_SunEphemerisInit() and then shared by every site evaluated at that
+    instant.
+*/
+
+struct CDT_SunEphemeris
+{
+    double mjd;     /*!< Modified Julian date (GMT) of the ephemeris. */
+    double ra;      /*!< Sun right ascension (hours, equinox of date). */
+    double dec;     /*!< Sun declination (degrees, equinox of date). */
+    double sinDec;  /*!< Sine of the sun declination. */
+    double cosDec;  /*!< Cosine of the sun declination. */
+    double gmst;    /*!< Greenwich mean sidereal time (unreduced hours). */
+};
+
+/*! \struct CDT_MoonEphemeris
+    \brief Lunar ephemeris for a single instant.
+
+    Like CDT_SunEphemeris, but for the moon.  Also carries the illuminated
+    fraction of the moon's disk, which depends only upon the time.  Computed
+    once per timestep by CDT_MoonEphemerisInit() and then shared by every
+    site evaluated at that instant.
+*/
+
+struct CDT_MoonEphemeris
+{
+    double mjd;      /*!< Modified Julian date (GMT) of the ephemeris. */
+    double ra;       /*!< Moon right ascension (hours, equinox of date). */
+    double dec;      /*!< Moon declination (degrees, equinox of date). */
+    double sinDec;   /*!< Sine of the moon declination. */
+    double cosDec;   /*!< Cosine of the moon declination. */
+    double gmst;     /*!< Greenwich mean sidereal time (unreduced hours). */
+    double fraction; /*!< Illuminated fraction of the moon's disk [0..1]. */
+};
+
+/*! \struct CDT_Normal
+    \brief Packed unit vector normal to a terrain surface.
+
+    The vector is expressed in local east (\a x), north (\a y), and up (\a z)
+    components.  Terrain never changes between timesteps, so the slope and
+    aspect trigonometry is done once by CDT_TerrainNormal() and the sun-to-slope
+    incidence then reduces to a dot product with the sun vector.
+*/
+
+struct CDT_Normal
+{
+    float x;        /*!< East component. */
+    float y;        /*!< North component. */
+    float z;        /*!< Up component. */
+};
+
 /*----------------------------------------------------------------------------*/
 /*  Static function prototypes                                                */
 /*----------------------------------------------------------------------------*/
 
+EXTERN double   CDT_AirMassElevationFactor( double elev ) ;
+
 EXTERN void     CDT_CalendarDate( double jd, int *year, int *month, int *day,
                     int *hour, int *minute, int *second, int *millisecond ) ;
 
+EXTERN long     CDT_DayNumber( int year, int month, int day ) ;
+
+EXTERN void     CDT_DayNumberArray( int n, const int *year, const int *month,
+                    const int *day, long *jdn ) ;
+
+EXTERN void     CDT_DayNumberDate( long jdn, int *year, int *month,
+                    int *day ) ;
+
+EXTERN void     CDT_DayNumberDateArray( int n, const long *jdn, int *year,
+                    int *month, int *day ) ;
+
 EXTERN int      CDT_DayOfWeek( double jdate ) ;
 
 EXTERN const char *CDT_DayOfWeekAbbreviation( int dowIndex ) ;
@@ -115,46 +183,157 @@ EXTERN const char *CDT_FlagName( int event ) ;
 
 EXTERN double   CDT_FractionalPart( double value ) ;
 
+EXTERN double   CDT_GreenwichSiderealTime( double mjd ) ;
+
 EXTERN double   CDT_JulianDate( int year, int month, int day, int hour,
                     int minute, int second, int millisecond ) ;
 
+EXTERN void     CDT_JulianDateSplit( double jdate, long *jdn,
+                    int *millisecondOfDay ) ;
+
 EXTERN int      CDT_LeapYear( int year ) ;
 
 EXTERN double   CDT_LocalMeanSiderealTime( double mjd, double lambda ) ;
 
+EXTERN double   CDT_LunationGMT( int lunation ) ;
+
+EXTERN int      CDT_LunationNumber( int year, int period ) ;
+
 EXTERN int      CDT_MillisecondOfDay( int hour, int minute, int second,
                     int millisecond ) ;
 
+EXTERN void     CDT_MillisecondTime( int ms, int *hour, int *minute,
+                    int *second, int *millisecond ) ;
+
 EXTERN double   CDT_ModifiedJulianDate( double jdate ) ;
 
 EXTERN const char *CDT_MonthAbbreviation( int month ) ;
 
 EXTERN const char *CDT_MonthName( int month ) ;
 
+EXTERN void     CDT_MoonEphemerisArray( int n, const double *jdate,
+                    double gmtDiff, struct CDT_MoonEphemeris *eph ) ;
+
+EXTERN void     CDT_MoonEphemerisInit( struct CDT_MoonEphemeris *eph,
+                    double jdate, double gmtDiff ) ;
+
+EXTERN double   CDT_MoonIllumination( double jdate, double gmtDiff ) ;
+
+EXTERN void     CDT_MoonPosition( double jdate, double lon, double lat,
+                    double gmtDiff, double *altitude, double *azimuth ) ;
+
+EXTERN void     CDT_MoonPositionEph( const struct CDT_MoonEphemeris *eph,
+                    double lon, double lat, double *altitude,
+                    double *azimuth ) ;
+
+EXTERN void     CDT_MoonPositionEphArray( const struct CDT_MoonEphemeris *eph,
+                    int n, const double *lon, const double *lat,
+                    double *altitude, double *azimuth ) ;
+
+EXTERN void     CDT_MoonPositionGrid( const struct CDT_MoonEphemeris *eph,
+                    int nTimes, int nSites, const double *lon,
+                    const double *lat, double *altitude, double *azimuth ) ;
+
 EXTERN double   CDT_NewMoonGMT( int year, int period ) ;
 
 EXTERN int      CDT_RiseSet( int event, double jdate, double lon, double lat,
                     double gmtDiff, double *hours ) ;
 
+EXTERN void     CDT_RiseSetAll( double jdate, double lon, double lat,
+                    double gmtDiff, int moon, double *hours, int *flags ) ;
+
+EXTERN void     CDT_RiseSetAllSamples( const double *sunAlt,
+                    const double *moonAlt, double *hours, int *flags ) ;
+
+EXTERN int      CDT_RiseSetNewton( int event, double jdate, double lon,
+                    double lat, double gmtDiff, double *hours ) ;
+
+EXTERN int      CDT_RiseSetSamples( int event, const double *sinAlt,
+                    double *hours ) ;
+
 EXTERN int      CDT_QuadraticRoots( double y_minus, double y_0, double y_plus,
                     double *xe, double *ye, double *zero1, double *zero2 ) ;
 
 EXTERN double   CDT_SineAltitude( int event, double mjd0, double hour,
                     double lambda, double cphi, double sphi ) ;
 
+EXTERN double   CDT_SineAltitudeEph( const struct CDT_SunEphemeris *eph,
+                    double lambda, double cphi, double sphi ) ;
+
+EXTERN void     CDT_SineAltitudeSamples( int event, double jdate, double lon,
+                    double lat, double gmtDiff, double *sinAlt ) ;
+
+EXTERN void     CDT_SkyPositionArray( double gmst, double ra, double sinDec,
+                    double cosDec, int n, const double *lonHours,
+                    const double *sinLat, const double *cosLat,
+                    double *altitude, double *azimuth ) ;
+
 EXTERN double   CDT_SolarAngle( double slope, double aspect, double altitude,
                     double azimuth ) ;
 
+EXTERN int      CDT_SolarDay( double jdate, double lon, double lat,
+                    double gmtDiff, double *transit, double *dayLength,
+                    double *maxAltitude, double *declination ) ;
+
+EXTERN void     CDT_SolarDayArray( int n, const double *jdate,
+                    const double *lon, const double *lat,
+                    const double *gmtDiff, double *transit,
+                    double *dayLength, double *maxAltitude,
+                    double *declination, int *flags ) ;
+
+EXTERN double   CDT_SolarIncidence( const struct CDT_Normal *normal,
+                    const double *sun ) ;
+
+EXTERN void     CDT_SunEphemerisArray( int n, const double *jdate,
+                    double gmtDiff, struct CDT_SunEphemeris *eph ) ;
+
+EXTERN void     CDT_SunEphemerisInit( struct CDT_SunEphemeris *eph,
+                    double jdate, double gmtDiff ) ;
+
 EXTERN void     CDT_SunPosition( double jdate, double lon, double lat,
                     double gmtDiff, double *altitude, double *azimuth ) ;
 
+EXTERN void     CDT_SunPositionArray( int n, const double *jdate,
+                    const double *lon, const double *lat,
+                    const double *gmtDiff, double *altitude,
+                    double *azimuth ) ;
+
+EXTERN void     CDT_SunPositionEph( const struct CDT_SunEphemeris *eph,
+                    double lon, double lat, double *altitude,
+                    double *azimuth ) ;
+
+EXTERN void     CDT_SunPositionEphArray( const struct CDT_SunEphemeris *eph,
+                    int n, const double *lon, const double *lat,
+                    double *altitude, double *azimuth ) ;
+
 EXTERN double   CDT_SolarRadiation ( double jdate, double lon, double lat,
                     double gmtDiff, double slope, double aspect, double elev,
                     double atmTransparency, double cloudTransmittance,
                     double canopyTransmittance ) ;
 
+EXTERN double   CDT_SolarRadiationEph( const struct CDT_SunEphemeris *eph,
+                    double lon, double lat, double slope, double aspect,
+                    double elev, double atmTransparency,
+                    double cloudTransmittance, double canopyTransmittance ) ;
+
+EXTERN double   CDT_SolarRadiationNormal( const double *sun,
+                    const struct CDT_Normal *normal, double elevFactor,
+                    double atmTransparency, double cloudTransmittance,
+                    double canopyTransmittance ) ;
+
 EXTERN double   CDT_SolsticeGMT( int event, int year ) ;
 
+EXTERN void     CDT_SunVector( double altitude, double azimuth, double *sun ) ;
+
+EXTERN void     CDT_SunVectorEph( const struct CDT_SunEphemeris *eph,
+                    double lon, double lat, double *sun ) ;
+
+EXTERN void     CDT_TerrainNormal( double slope, double aspect,
+                    struct CDT_Normal *normal ) ;
+
+EXTERN void     CDT_TerrainNormalArray( int n, const double *slope,
+                    const double *aspect, struct CDT_Normal *normal ) ;
+
 EXTERN int      CDT_ValidDate( int year, int month, int day ) ;
 
 EXTERN int      CDT_ValidDateTime( int year, int month, int day,
@@ -0,0 +1,892 @@
+/*----------------------------------------------------------------------------*/
+/*! \file cdtsimd.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Calendar-Date-Time (CDT) library vectorized solar and calendar
+ *  kernels.
+ *
+ *  Batch versions of CDT_MiniSun(), CDT_GreenwichSiderealTime(),
+ *  CDT_LocalMeanSiderealTime(), CDT_CalendarDate(), and CDT_JulianDate()
+ *  from cdtlib.c.  The kernels are written once
+ *  as templates over the lane type, using GCC vector extensions, and
+ *  instantiated for plain doubles (portable scalar), SSE2 (2 lanes), AVX2
+ *  (4 lanes), and AVX-512F (8 lanes).  The widest instruction set supported
+ *  by the CPU is selected on first use.
+ *
+ *  The library's sin(), cos(), and atan() calls are replaced by the Cephes
+ *  polynomial and rational approximations (Moshier, 1989), and floor() by
+ *  the 2^52 rounding trick, so every operation maps to a vector
+ *  instruction.
+ *
+ *  \par Accuracy:
+ *
+ *  Measured against CDT_SunEphemerisInit() at hourly steps over 1900-2100,
+ *  the maximum absolute differences are 1e-11 hours in right ascension,
+ *  3e-12 degrees in declination, 5e-14 in the sine and cosine of
+ *  declination, and 3e-14 hours in sidereal time (the SSE2 and scalar
+ *  variants reproduce the sidereal times exactly; AVX2 and AVX-512 differ
+ *  slightly because of fused multiply-adds).  The differences grow with
+ *  the distance from J2000, since the polynomial arguments grow with it.
+ *  Over 2 million random dates from -4712 through 9999 they are below
+ *  3e-11 hours in right ascension and sidereal time, 2e-10 degrees in
+ *  declination, and 3e-12 in its sine and cosine.  Even that is seven
+ *  orders of magnitude below the 1' accuracy of the underlying
+ *  low-precision solar theory.  The polynomial sine and cosine are
+ *  accurate to 2 ulp for |x| < 1e8, and the arctangent to 2 ulp everywhere;
+ *  the rounding trick requires |x| < 2^51.
+ *
+ *  The calendar kernels do the integer day number arithmetic of
+ *  CDT_DayNumber() and CDT_DayNumberDate() in double lanes, where every
+ *  quantity is a non-negative integer below 2^35 and the floor of each
+ *  correctly rounded quotient is exact, so their results are identical to
+ *  the scalar routines.
+ *
+ *  \par References:
+ *
+ *  Moshier, Stephen L.  1989.  Methods and programs for mathematical
+ *  functions.  Prentice-Hall.  415 pp.
+ */
+
+/* Custom include files */
+#include "cdtsimd.h"
+
+/* Standard include files */
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+/*! \def CDT_SIMD_X86
+    \internal
+    \brief Defined when the x86 SIMD kernels are compiled.
+ */
+#define CDT_SIMD_X86 1
+#include <immintrin.h>
+/* The helpers pass vectors by value, but are always inlined */
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/*! \def CDT_FLATTEN
+    \internal
+    \brief Inlines all the lane-generic helpers into each instruction set
+    variant so they are compiled for that variant's target.
+ */
+#if defined(__GNUC__)
+#define CDT_FLATTEN __attribute__((flatten))
+#else
+#define CDT_FLATTEN
+#endif
+
+/*! \def CDT_INLINE
+    \internal
+    \brief Declares a lane-generic helper.
+ */
+#define CDT_INLINE static inline
+
+/*! \var static const double Radians
+ *  \brief Global constant defining the radians per degree.
+ */
+static const double Radians = 0.0174532925199433;
+
+/* Cephes sin() and cos() reduction and polynomial coefficients */
+static const double DP1 = 7.85398125648498535156E-1;
+static const double DP2 = 3.77489470793079817668E-8;
+static const double DP3 = 2.69515142907905952645E-15;
+static const double FourOverPi = 1.27323954473516268615;
+
+/* Cephes atan() constants */
+static const double T3P8 = 2.41421356237309504880;
+static const double MoreBits = 6.123233995736765886130E-17;
+static const double PiOver2 = 1.57079632679489661923;
+static const double PiOver4 = 7.85398163397448309616E-1;
+
+/* Requested and detected instruction sets (-1 until detected) */
+static int SimdLevel = -1;
+static int SimdMaximum = -1;
+
+/*----------------------------------------------------------------------------*/
+/*  Lane types and the operations that need an instruction per lane type     */
+/*----------------------------------------------------------------------------*/
+
+#ifdef CDT_SIMD_X86
+typedef double CDT_V2 __attribute__((vector_size(16)));
+typedef double CDT_V4 __attribute__((vector_size(32)));
+typedef double CDT_V8 __attribute__((vector_size(64)));
+
+__attribute__((target("sse2")))
+CDT_INLINE CDT_V2 Sqrt( const CDT_V2 &x )
+{
+    return( (CDT_V2) _mm_sqrt_pd( (__m128d) x ) );
+}
+
+__attribute__((target("avx")))
+CDT_INLINE CDT_V4 Sqrt( const CDT_V4 &x )
+{
+    return( (CDT_V4) _mm256_sqrt_pd( (__m256d) x ) );
+}
+
+__attribute__((target("avx512f")))
+CDT_INLINE CDT_V8 Sqrt( const CDT_V8 &x )
+{
+    return( (CDT_V8) _mm512_maskz_sqrt_pd( 0xFF, (__m512d) x ) );
+}
+#endif
+
+CDT_INLINE double Sqrt( const double &x )
+{
+    return( sqrt( x ) );
+}
+
+/*----------------------------------------------------------------------------*/
+/*  Lane-generic math                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*! \brief Rounds each lane toward negative infinity.
+ *
+ *  Adding and subtracting 1.5 * 2^52 rounds to the nearest integer in the
+ *  default rounding mode, which is then corrected downward where it
+ *  rounded up.  Requires |x| < 2^51.
+ */
+
+template <class V>
+CDT_INLINE V Floor( const V &x )
+{
+    const double magic = 6755399441055744.0;
+    V r = ( x + magic ) - magic;
+    return( ( r > x ) ? r - 1. : r );
+}
+
+/*! \brief Same as CDT_FractionalPart() for each lane.
+ */
+
+template <class V>
+CDT_INLINE V Frac( const V &x )
+{
+    V i = ( x < 0. ) ? -Floor( -x ) : Floor( x );
+    V f = x - i;
+    return( ( f < 0. ) ? f + 1. : f );
+}
+
+/*! \brief Cephes sin() and cos() of each lane (radians).
+ */
+
+template <class V>
+CDT_INLINE void SinCos( const V &x, V *s, V *c )
+{
+    V ax = ( x < 0. ) ? -x : x;
+    V y = Floor( ax * FourOverPi );
+    V j = y - 8. * Floor( y * 0.125 );
+    /* Map zeros to origin */
+    V odd = j - 2. * Floor( j * 0.5 );
+    y = y + odd;
+    j = j + odd;
+    j = ( j > 7. ) ? j - 8. : j;
+    V z = ( ( ax - y * DP1 ) - y * DP2 ) - y * DP3;
+    V zz = z * z;
+    V sp = z + z * zz * ( ( ( ( ( 1.58962301576546568060E-10 * zz
+        - 2.50507477628578072866E-8 ) * zz + 2.75573136213857245213E-6 ) * zz
+        - 1.98412698295895385996E-4 ) * zz + 8.33333333332211858878E-3 ) * zz
+        - 1.66666666666666307295E-1 );
+    V cp = 1. - 0.5 * zz + zz * zz * ( ( ( ( ( -1.13585365213876817300E-11
+        * zz + 2.08757008419747316778E-9 ) * zz - 2.75573141792967388112E-7 )
+        * zz + 2.48015872888517045348E-5 ) * zz - 1.38888888888730564116E-3 )
+        * zz + 4.16666666666665929218E-2 );
+    /* Octants 0, 2, 4, 6 */
+    V swap = j - 4. * Floor( j * 0.25 );
+    V sr = ( swap > 1. ) ? cp : sp;
+    V cr = ( swap > 1. ) ? sp : cp;
+    sr = ( j > 3. ) ? -sr : sr;
+    cr = ( j > 1. && j < 5. ) ? -cr : cr;
+    *s = ( x < 0. ) ? -sr : sr;
+    *c = cr;
+    return;
+}
+
+/*! \brief Cephes atan() of each lane (radians).
+ */
+
+template <class V>
+CDT_INLINE V Atan( const V &x )
+{
+    V ax = ( x < 0. ) ? -x : x;
+    V big = ( ax > T3P8 ) ? ax : 1.;
+    V mid = ( ax > 0.66 ) ? ( ax - 1. ) / ( ax + 1. ) : ax;
+    V xr = ( ax > T3P8 ) ? -1. / big : mid;
+    V y = ( ax > T3P8 ) ? PiOver2 : ( ( ax > 0.66 ) ? PiOver4 : 0. );
+    V more = ( ax > T3P8 ) ? MoreBits : ( ( ax > 0.66 ) ? 0.5 * MoreBits : 0. );
+    V z = xr * xr;
+    V p = ( ( ( -8.750608600031904122785E-1 * z
+        - 1.615753718733365076637E1 ) * z - 7.500855792314704667340E1 ) * z
+        - 1.228866684490136173410E2 ) * z - 6.485021904942025371773E1;
+    V q = ( ( ( ( z + 2.485846490142306297962E1 ) * z
+        + 1.650270098316988542046E2 ) * z + 4.328810604912902668951E2 ) * z
+        + 4.853903996359136964868E2 ) * z + 1.945506571482613964425E2;
+    z = xr * ( z * p / q ) + xr + more;
+    y = y + z;
+    return( ( x < 0. ) ? -y : y );
+}
+
+/*----------------------------------------------------------------------------*/
+/*  Lane-generic solar kernel                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*! \brief Evaluates CDT_MiniSun() and the sidereal times for one lane group.
+ *
+ *  Any output may be NULL.  \a sinDec and \a cosDec require \a dec.
+ */
+
+template <class V>
+CDT_INLINE void SunLanes( const double *mjdp, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    const double p2 = 6.283185307;
+    const double coseps = 0.91748;
+    const double sineps = 0.39778;
+    V mjd, t, m, sm, cm, l, sl, cl, y, z, rho, v, g, s, c;
+
+    memcpy( &mjd, mjdp, sizeof(V) );
+    if ( ra || dec )
+    {
+        /* Same expression order as CDT_MiniSun() */
+        t = ( mjd - 51544.5 ) / 36525.0;
+        m = p2 * Frac( 0.993133 + 99.997361 * t );
+        SinCos( m, &sm, &cm );
+        v = 6893.0 * sm + 72.0 * ( 2. * sm * cm );
+        l = p2 * Frac( 0.7859453 + m / p2 + ( 6191.2 * t + v ) / 1296e3 );
+        SinCos( l, &sl, &cl );
+        y = coseps * sl;
+        z = sineps * sl;
+        rho = Sqrt( 1.0 - z * z );
+        if ( dec )
+        {
+            v = ( 360.0 / p2 ) * Atan( z / rho );
+            memcpy( dec + 0, &v, sizeof(V) );
+            if ( sinDec || cosDec )
+            {
+                SinCos( Radians * v, &s, &c );
+                if ( sinDec )
+                {
+                    memcpy( sinDec, &s, sizeof(V) );
+                }
+                if ( cosDec )
+                {
+                    memcpy( cosDec, &c, sizeof(V) );
+                }
+            }
+        }
+        if ( ra )
+        {
+            v = ( 48.0 / p2 ) * Atan( y / ( cl + rho ) );
+            v = ( v < 0. ) ? v + 24. : v;
+            memcpy( ra, &v, sizeof(V) );
+        }
+    }
+    if ( gmst || lmst )
+    {
+        /* Same as CDT_GreenwichSiderealTime() */
+        V mjd0 = ( mjd < 0. ) ? -Floor( -mjd ) : Floor( mjd );
+        V ut = 24. * ( mjd - mjd0 );
+        t = ( mjd0 - 51544.5 ) / 36525.0;
+        g = 6.697374558 + 1.0027379093 * ut
+          + ( 8640184.812866 + ( 0.093104 - 6.2e-6 * t ) * t ) * t / 3600.0;
+        if ( gmst )
+        {
+            memcpy( gmst, &g, sizeof(V) );
+        }
+        if ( lmst )
+        {
+            v = 24.0 * Frac( ( g - lambda / 15.0 ) / 24.0 );
+            memcpy( lmst, &v, sizeof(V) );
+        }
+    }
+    return;
+}
+
+/*! \brief Runs SunLanes() over \a n dates, \a V lanes at a time, finishing
+ *  the remainder one date at a time.
+ */
+
+template <class V>
+CDT_INLINE void SunLoop( int n, const double *mjd, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    const int w = (int) ( sizeof(V) / sizeof(double) );
+    int i = 0;
+    for ( ; i + w <= n; i += w )
+    {
+        SunLanes<V>( mjd + i, lambda,
+            ra ? ra + i : 0, dec ? dec + i : 0,
+            sinDec ? sinDec + i : 0, cosDec ? cosDec + i : 0,
+            gmst ? gmst + i : 0, lmst ? lmst + i : 0 );
+    }
+    for ( ; i < n; i++ )
+    {
+        SunLanes<double>( mjd + i, lambda,
+            ra ? ra + i : 0, dec ? dec + i : 0,
+            sinDec ? sinDec + i : 0, cosDec ? cosDec + i : 0,
+            gmst ? gmst + i : 0, lmst ? lmst + i : 0 );
+    }
+    return;
+}
+
+/*! \brief Loads \a V lanes of integers.
+ */
+
+template <class V>
+CDT_INLINE V LoadInt( const int *p )
+{
+    double lane[ sizeof(V) / sizeof(double) ];
+    V v;
+    for ( int k = 0; k < (int) ( sizeof(V) / sizeof(double) ); k++ )
+    {
+        lane[k] = p[k];
+    }
+    memcpy( &v, lane, sizeof(V) );
+    return( v );
+}
+
+/*! \brief Stores \a V lanes of integral values as integers.
+ */
+
+template <class V>
+CDT_INLINE void StoreInt( const V &v, int *p )
+{
+    double lane[ sizeof(V) / sizeof(double) ];
+    memcpy( lane, &v, sizeof(V) );
+    for ( int k = 0; k < (int) ( sizeof(V) / sizeof(double) ); k++ )
+    {
+        p[k] = (int) lane[k];
+    }
+    return;
+}
+
+/*! \brief Evaluates CDT_JulianDateSplit() and CDT_DayNumberDate() for one
+ *  lane group.
+ */
+
+template <class V>
+CDT_INLINE void CalendarLanes( const double *jdatep, int *year, int *month,
+    int *day, int *msOfDay )
+{
+    V x, jdn, ms, f, e, g, h;
+
+    /* Same as CDT_JulianDateSplit() */
+    memcpy( &x, jdatep, sizeof(V) );
+    x = x + 0.5;
+    jdn = Floor( x );
+    ms = Floor( ( x - jdn ) * 86400000. + 0.5 );
+    jdn = ( ms >= 86400000. ) ? jdn + 1. : jdn;
+    ms = ( ms >= 86400000. ) ? ms - 86400000. : ms;
+    StoreInt( ms, msOfDay );
+
+    /* Same as CDT_DayNumberDate() */
+    f = jdn + 1401.;
+    g = Floor( Floor( ( 4. * jdn + 274277. ) / 146097. ) * 3. / 4. ) - 38.;
+    f = ( jdn >= 2299161. ) ? f + g : f;
+    e = 4. * f + 3.;
+    g = Floor( ( e - 1461. * Floor( e / 1461. ) ) / 4. );
+    h = 5. * g + 2.;
+    StoreInt( V( Floor( ( h - 153. * Floor( h / 153. ) ) / 5. ) + 1. ), day );
+    g = Floor( h / 153. ) + 2.;
+    g = g - 12. * Floor( g / 12. ) + 1.;
+    StoreInt( g, month );
+    StoreInt( V( Floor( e / 1461. ) - 4716. + Floor( ( 14. - g ) / 12. ) ),
+        year );
+    return;
+}
+
+/*! \brief Evaluates CDT_DayNumber() and the CDT_JulianDate() sum for one
+ *  lane group.
+ */
+
+template <class V>
+CDT_INLINE void JulianLanes( const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    V y, m, d, ms, jdn, greg;
+
+    y = LoadInt<V>( year );
+    m = LoadInt<V>( month );
+    d = LoadInt<V>( day );
+    ms = LoadInt<V>( msOfDay );
+
+    /* Same as CDT_DayNumber() */
+    greg = 10000. * y + 100. * m + d;
+    y = ( m <= 2. ) ? y + 4799. : y + 4800.;
+    m = ( m <= 2. ) ? m + 9. : m - 3.;
+    jdn = d + Floor( ( 153. * m + 2. ) / 5. ) + 365. * y + Floor( y / 4. );
+    jdn = ( greg >= 15821015. )
+        ? jdn - Floor( y / 100. ) + Floor( y / 400. ) - 32045.
+        : jdn - 32083.;
+
+    /* Same order as CDT_JulianDate() */
+    jdn = ( jdn - 1720995. ) + ms / 86400000. + 1720994.5;
+    memcpy( jdate, &jdn, sizeof(V) );
+    return;
+}
+
+/*! \brief Runs CalendarLanes() over \a n dates, \a V lanes at a time,
+ *  finishing the remainder one date at a time.
+ */
+
+template <class V>
+CDT_INLINE void CalendarLoop( int n, const double *jdate, int *year,
+    int *month, int *day, int *msOfDay )
+{
+    const int w = (int) ( sizeof(V) / sizeof(double) );
+    int i = 0;
+    for ( ; i + w <= n; i += w )
+    {
+        CalendarLanes<V>( jdate + i, year + i, month + i, day + i,
+            msOfDay + i );
+    }
+    for ( ; i < n; i++ )
+    {
+        CalendarLanes<double>( jdate + i, year + i, month + i, day + i,
+            msOfDay + i );
+    }
+    return;
+}
+
+/*! \brief Runs JulianLanes() over \a n dates, \a V lanes at a time,
+ *  finishing the remainder one date at a time.
+ */
+
+template <class V>
+CDT_INLINE void JulianLoop( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    const int w = (int) ( sizeof(V) / sizeof(double) );
+    int i = 0;
+    for ( ; i + w <= n; i += w )
+    {
+        JulianLanes<V>( year + i, month + i, day + i, msOfDay + i,
+            jdate + i );
+    }
+    for ( ; i < n; i++ )
+    {
+        JulianLanes<double>( year + i, month + i, day + i, msOfDay + i,
+            jdate + i );
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*  Instruction set variants                                                  */
+/*----------------------------------------------------------------------------*/
+
+CDT_FLATTEN
+static void SunScalar( int n, const double *mjd, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    SunLoop<double>( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+}
+
+#ifdef CDT_SIMD_X86
+__attribute__((target("sse2"))) CDT_FLATTEN
+static void SunSSE2( int n, const double *mjd, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    SunLoop<CDT_V2>( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+}
+
+__attribute__((target("avx2,fma"))) CDT_FLATTEN
+static void SunAVX2( int n, const double *mjd, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    SunLoop<CDT_V4>( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+}
+
+__attribute__((target("avx512f"))) CDT_FLATTEN
+static void SunAVX512( int n, const double *mjd, double lambda, double *ra,
+    double *dec, double *sinDec, double *cosDec, double *gmst, double *lmst )
+{
+    SunLoop<CDT_V8>( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+}
+#endif
+
+/*! \brief Portable calendar variants, which simply call the integer
+ *  cdtlib.c routines (scalar integer division is faster than the double
+ *  lane arithmetic without SIMD).
+ */
+
+static void CalendarScalar( int n, const double *jdate, int *year,
+    int *month, int *day, int *msOfDay )
+{
+    long jdn;
+    for ( int i = 0; i < n; i++ )
+    {
+        CDT_JulianDateSplit( jdate[i], &jdn, &msOfDay[i] );
+        CDT_DayNumberDate( jdn, &year[i], &month[i], &day[i] );
+    }
+}
+
+static void JulianScalar( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    long jdn;
+    for ( int i = 0; i < n; i++ )
+    {
+        jdn = CDT_DayNumber( year[i], month[i], day[i] );
+        jdate[i] = (double) ( jdn - 1720995L )
+                 + (double) msOfDay[i] / 86400000. + 1720994.5;
+    }
+}
+
+#ifdef CDT_SIMD_X86
+__attribute__((target("sse2"))) CDT_FLATTEN
+static void CalendarSSE2( int n, const double *jdate, int *year, int *month,
+    int *day, int *msOfDay )
+{
+    CalendarLoop<CDT_V2>( n, jdate, year, month, day, msOfDay );
+}
+
+__attribute__((target("avx2,fma"))) CDT_FLATTEN
+static void CalendarAVX2( int n, const double *jdate, int *year, int *month,
+    int *day, int *msOfDay )
+{
+    CalendarLoop<CDT_V4>( n, jdate, year, month, day, msOfDay );
+}
+
+__attribute__((target("avx512f"))) CDT_FLATTEN
+static void CalendarAVX512( int n, const double *jdate, int *year,
+    int *month, int *day, int *msOfDay )
+{
+    CalendarLoop<CDT_V8>( n, jdate, year, month, day, msOfDay );
+}
+
+__attribute__((target("sse2"))) CDT_FLATTEN
+static void JulianSSE2( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    JulianLoop<CDT_V2>( n, year, month, day, msOfDay, jdate );
+}
+
+__attribute__((target("avx2,fma"))) CDT_FLATTEN
+static void JulianAVX2( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    JulianLoop<CDT_V4>( n, year, month, day, msOfDay, jdate );
+}
+
+__attribute__((target("avx512f"))) CDT_FLATTEN
+static void JulianAVX512( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    JulianLoop<CDT_V8>( n, year, month, day, msOfDay, jdate );
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Dispatches the solar kernel to the selected instruction set.
+ *
+ *  \internal
+ */
+
+static void CDT_SunKernel( int n, const double *mjd, double lambda,
+    double *ra, double *dec, double *sinDec, double *cosDec, double *gmst,
+    double *lmst )
+{
+    switch ( CDT_SimdLevel() )
+    {
+#ifdef CDT_SIMD_X86
+    case CDT_SimdAVX512:
+        SunAVX512( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+        break;
+    case CDT_SimdAVX2:
+        SunAVX2( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+        break;
+    case CDT_SimdSSE2:
+        SunSSE2( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+        break;
+#endif
+    default:
+        SunScalar( n, mjd, lambda, ra, dec, sinDec, cosDec, gmst, lmst );
+        break;
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Dispatches the Julian date to calendar date kernel to the
+ *  selected instruction set.
+ *
+ *  \internal
+ */
+
+static void CDT_CalendarKernel( int n, const double *jdate, int *year,
+    int *month, int *day, int *msOfDay )
+{
+    switch ( CDT_SimdLevel() )
+    {
+#ifdef CDT_SIMD_X86
+    case CDT_SimdAVX512:
+        CalendarAVX512( n, jdate, year, month, day, msOfDay );
+        break;
+    case CDT_SimdAVX2:
+        CalendarAVX2( n, jdate, year, month, day, msOfDay );
+        break;
+    case CDT_SimdSSE2:
+        CalendarSSE2( n, jdate, year, month, day, msOfDay );
+        break;
+#endif
+    default:
+        CalendarScalar( n, jdate, year, month, day, msOfDay );
+        break;
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Dispatches the calendar date to Julian date kernel to the
+ *  selected instruction set.
+ *
+ *  \internal
+ */
+
+static void CDT_JulianKernel( int n, const int *year, const int *month,
+    const int *day, const int *msOfDay, double *jdate )
+{
+    switch ( CDT_SimdLevel() )
+    {
+#ifdef CDT_SIMD_X86
+    case CDT_SimdAVX512:
+        JulianAVX512( n, year, month, day, msOfDay, jdate );
+        break;
+    case CDT_SimdAVX2:
+        JulianAVX2( n, year, month, day, msOfDay, jdate );
+        break;
+    case CDT_SimdSSE2:
+        JulianSSE2( n, year, month, day, msOfDay, jdate );
+        break;
+#endif
+    default:
+        JulianScalar( n, year, month, day, msOfDay, jdate );
+        break;
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*  Public functions                                                          */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the calendar date and the millisecond of the day for
+ *  each of an array of Julian dates.
+ *
+ *  Batch version of CDT_CalendarDate(), writing each field to its own
+ *  column.  The results are identical to CDT_JulianDateSplit() followed by
+ *  CDT_DayNumberDate().
+ *
+ *  \param n Number of dates.
+ *  \param jdate Array of \a n Julian dates (-0.5 or later).
+ *  \param year Returned array of \a n Julian-Gregorian years.
+ *  \param month Returned array of \a n months of the year (1-12).
+ *  \param day Returned array of \a n days of the month (1-31).
+ *  \param millisecondOfDay Returned array of \a n milliseconds since
+ *  midnight (0-86399999), rounded to the nearest millisecond.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_JulianDateArray(), CDT_MillisecondTime().
+ */
+
+void CDT_CalendarDateArray( int n, const double *jdate, int *year,
+        int *month, int *day, int *millisecondOfDay )
+{
+    CDT_CalendarKernel( n, jdate, year, month, day, millisecondOfDay );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the unreduced Greenwich mean sidereal time for each of
+ *  an array of modified Julian dates.
+ *
+ *  \param n Number of dates.
+ *  \param mjd Array of \a n modified Julian dates (JD - 2400000.5).
+ *  \param gmst Returned array of \a n Greenwich mean sidereal times in
+ *  hours, \e not reduced to the range [0..24).
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_GreenwichSiderealTimeArray( int n, const double *mjd, double *gmst )
+{
+    CDT_SunKernel( n, mjd, 0., 0, 0, 0, 0, gmst, 0 );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the Julian date for each of an array of calendar
+ *  dates and milliseconds of the day.
+ *
+ *  Batch version of CDT_JulianDate(), reading each field from its own
+ *  column.  The results are identical to CDT_JulianDate().
+ *
+ *  \param n Number of dates.
+ *  \param year Array of \a n Julian-Gregorian years (-4712 or later).
+ *  \param month Array of \a n months of the year (1-12).
+ *  \param day Array of \a n days of the month (1-31).
+ *  \param millisecondOfDay Array of \a n milliseconds since midnight, as
+ *  from CDT_MillisecondOfDay().
+ *  \param jdate Returned array of \a n Julian dates.
+ *
+ *  \return The function returns nothing.
+ *
+ *  \sa CDT_CalendarDateArray().
+ */
+
+void CDT_JulianDateArray( int n, const int *year, const int *month,
+        const int *day, const int *millisecondOfDay, double *jdate )
+{
+    CDT_JulianKernel( n, year, month, day, millisecondOfDay, jdate );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the local mean sidereal time for each of an array of
+ *  modified Julian dates at a single longitude.
+ *
+ *  Batch version of CDT_LocalMeanSiderealTime().
+ *
+ *  \param n Number of dates.
+ *  \param mjd Array of \a n modified Julian dates (JD - 2400000.5).
+ *  \param lambda Longitude in degrees (west of Greenwich is positive).
+ *  \param lmst Returned array of \a n local mean sidereal times in hours.
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_LocalMeanSiderealTimeArray( int n, const double *mjd, double lambda,
+        double *lmst )
+{
+    CDT_SunKernel( n, mjd, lambda, 0, 0, 0, 0, 0, lmst );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines low precision solar coordinates (approximately 1') for
+ *  each of an array of modified Julian dates.
+ *
+ *  Batch version of the static CDT_MiniSun() in cdtlib.c.
+ *
+ *  \param n Number of dates.
+ *  \param mjd Array of \a n modified Julian dates (JD - 2400000.5).
+ *  \param ra Returned array of \a n right ascensions (hours, equinox of
+ *  date).
+ *  \param dec Returned array of \a n declinations (degrees, equinox of date).
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_MiniSunArray( int n, const double *mjd, double *ra, double *dec )
+{
+    CDT_SunKernel( n, mjd, 0., ra, dec, 0, 0, 0, 0 );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Gets the instruction set used by the vectorized kernels.
+ *
+ *  On first call, detects the widest instruction set supported by the CPU.
+ *
+ *  \return One of the #CDT_Simd enumeration values.
+ */
+
+int CDT_SimdLevel( void )
+{
+    if ( SimdLevel < 0 )
+    {
+        int level = CDT_SimdScalar;
+#ifdef CDT_SIMD_X86
+        __builtin_cpu_init();
+        if ( __builtin_cpu_supports( "avx512f" ) )
+        {
+            level = CDT_SimdAVX512;
+        }
+        else if ( __builtin_cpu_supports( "avx2" )
+               && __builtin_cpu_supports( "fma" ) )
+        {
+            level = CDT_SimdAVX2;
+        }
+        else if ( __builtin_cpu_supports( "sse2" ) )
+        {
+            level = CDT_SimdSSE2;
+        }
+#endif
+        SimdMaximum = level;
+        SimdLevel = level;
+    }
+    return( SimdLevel );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Selects the instruction set used by the vectorized kernels.
+ *
+ *  Mainly for testing and benchmarking; the default is the widest
+ *  instruction set supported by the CPU.
+ *
+ *  \param level One of the #CDT_Simd enumeration values.  Levels above
+ *  what the CPU supports are reduced to what it does support.
+ *
+ *  \return The #CDT_Simd enumeration value actually selected.
+ */
+
+int CDT_SimdLevelSet( int level )
+{
+    CDT_SimdLevel();
+    if ( level < CDT_SimdScalar )
+    {
+        level = CDT_SimdScalar;
+    }
+    SimdLevel = ( level < SimdMaximum ) ? level : SimdMaximum;
+    return( SimdLevel );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Determines the solar ephemeris for each of an array of dates
+ *  using the vectorized kernels.
+ *
+ *  Same as CDT_SunEphemerisArray() to within the error bounds given in
+ *  the file description.
+ *
+ *  \param n Number of dates.
+ *  \param jdate Array of \a n Julian date-times.
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param eph Returned array of \a n solar ephemerides.
+ *
+ *  \return The function returns nothing.
+ */
+
+void CDT_SunEphemerisArrayFast( int n, const double *jdate, double gmtDiff,
+        struct CDT_SunEphemeris *eph )
+{
+    enum { Block = 64 };
+    double mjd[Block], ra[Block], dec[Block], sd[Block], cd[Block], g[Block];
+    int i, j, k;
+
+    for ( i = 0; i < n; i += Block )
+    {
+        k = ( n - i < Block ) ? n - i : Block;
+        for ( j = 0; j < k; j++ )
+        {
+            mjd[j] = jdate[i+j] - 2400000.5 - ( gmtDiff / 24. );
+        }
+        CDT_SunKernel( k, mjd, 0., ra, dec, sd, cd, g, 0 );
+        for ( j = 0; j < k; j++ )
+        {
+            eph[i+j].mjd    = mjd[j];
+            eph[i+j].ra     = ra[j];
+            eph[i+j].dec    = dec[j];
+            eph[i+j].sinDec = sd[j];
+            eph[i+j].cosDec = cd[j];
+            eph[i+j].gmst   = g[j];
+        }
+    }
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*  End of cdtsimd.cpp                                                        */
+/*----------------------------------------------------------------------------*/
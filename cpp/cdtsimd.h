@@ -0,0 +1,67 @@
+/*----------------------------------------------------------------------------*/
+/*! \file cdtsimd.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Calendar-Date-Time (CDT) library vectorized solar and calendar
+ *  kernels header.
+ *
+ *  Batch versions of the solar coordinate, sidereal time, and calendar
+ *  conversion routines in cdtlib.c that process 2, 4, or 8 dates per
+ *  instruction using the widest SIMD instruction set available at run time.
+ */
+
+#ifndef _CDTSIMD_H_
+/*! \def _CDTSIMD_H_
+    \internal
+    \brief Prevents redundant inclusion of the cdtsimd.h header file.
+ */
+#define _CDTSIMD_H_ 1
+
+#include "cdtlib.h"
+
+/*! \enum CDT_Simd
+    \brief Identifies the instruction set used by the vectorized kernels.
+*/
+
+enum CDT_Simd
+{
+    CDT_SimdScalar  = 0, /*!< Portable scalar code (one date at a time). */
+    CDT_SimdSSE2    = 1, /*!< SSE2 (2 dates per instruction). */
+    CDT_SimdAVX2    = 2, /*!< AVX2 and FMA (4 dates per instruction). */
+    CDT_SimdAVX512  = 3  /*!< AVX-512F (8 dates per instruction). */
+};
+
+/*----------------------------------------------------------------------------*/
+/*  Function prototypes                                                       */
+/*----------------------------------------------------------------------------*/
+
+EXTERN void     CDT_CalendarDateArray( int n, const double *jdate,
+                    int *year, int *month, int *day,
+                    int *millisecondOfDay ) ;
+
+EXTERN void     CDT_GreenwichSiderealTimeArray( int n, const double *mjd,
+                    double *gmst ) ;
+
+EXTERN void     CDT_JulianDateArray( int n, const int *year,
+                    const int *month, const int *day,
+                    const int *millisecondOfDay, double *jdate ) ;
+
+EXTERN void     CDT_LocalMeanSiderealTimeArray( int n, const double *mjd,
+                    double lambda, double *lmst ) ;
+
+EXTERN void     CDT_MiniSunArray( int n, const double *mjd, double *ra,
+                    double *dec ) ;
+
+EXTERN int      CDT_SimdLevel( void ) ;
+
+EXTERN int      CDT_SimdLevelSet( int level ) ;
+
+EXTERN void     CDT_SunEphemerisArrayFast( int n, const double *jdate,
+                    double gmtDiff, struct CDT_SunEphemeris *eph ) ;
+
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*  End of cdtsimd.h                                                          */
+/*----------------------------------------------------------------------------*/
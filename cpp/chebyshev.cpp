@@ -0,0 +1,611 @@
+//------------------------------------------------------------------------------
+/*! \file chebyshev.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Chebyshev polynomial ephemeris C++ source code.
+ *
+ *  The ChebyshevEphemeris class fits the Calendar-Date-Time Library solar
+ *  or lunar coordinates in cdtlib.c over a span of days, and determines
+ *  rise, set, and twilight times from the fit.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "chebyshev.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+
+static const double Radians = 0.0174532925199433;
+static const double Pi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the equation of time from the sun's right ascension.
+ *
+ *  Uses the sun's mean longitude from the same theory as CDT_MiniSun().
+ *
+ *  \param jdate Julian date (GMT).
+ *  \param ra Sun right ascension (hours, equinox of date).
+ *
+ *  \return Equation of time (apparent minus mean solar time) in minutes.
+ */
+
+static double EquationOfTime( double jdate, double ra )
+{
+    double t = ( jdate - 2451545.0 ) / 36525.0;
+    double l = 0.7859453 + 0.993133 + 99.997361 * t + 6191.2 * t / 1296e3;
+    double e = l - ra / 24.;
+    e -= floor( e + 0.5 );
+    return( 1440. * e );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new ChebyshevEphemeris and fits its series.
+ *
+ *  The default fits (32-day segments of order 12 for the sun, 4-day
+ *  segments of order 14 for the moon) reproduce the declination to about
+ *  2e-5 arc seconds, which is the size of the tiny steps in CDT_MiniSun()
+ *  and CDT_MiniMoon() themselves where their arguments wrap.
+ *
+ *  \param jdate Julian date (GMT) of the start of the span.
+ *  \param days Length of the span in days.
+ *  \param moon TRUE to fit the moon, FALSE to fit the sun.
+ *  \param segmentDays Length of each segment in days, or 0 for the body's
+ *  default.  The span is rounded up to a whole number of segments.
+ *  \param order Order of each Chebyshev series, or 0 for the body's
+ *  default.
+ */
+
+ChebyshevEphemeris::ChebyshevEphemeris( double jdate, double days, bool moon,
+        double segmentDays, int order ) :
+    m_moon(moon),
+    m_series(moon ? 4 : 3),
+    m_start(jdate),
+    m_segmentDays(segmentDays),
+    m_segments(0),
+    m_order(order),
+    m_coef(0)
+{
+    if ( m_segmentDays <= 0. )
+    {
+        m_segmentDays = m_moon ? 4. : 32.;
+    }
+    if ( m_order < 1 )
+    {
+        m_order = m_moon ? 14 : 12;
+    }
+    m_segments = (int) ceil( days / m_segmentDays );
+    if ( m_segments < 1 )
+    {
+        m_segments = 1;
+    }
+    int nc = m_order + 1;
+    m_coef = new double[ m_series * nc * m_segments ];
+
+    // Chebyshev nodes and the function values there
+    double *node = new double[ nc ];
+    double *f = new double[ m_series * nc ];
+    for ( int seg = 0; seg < m_segments; seg++ )
+    {
+        double a = m_start + seg * m_segmentDays;
+        for ( int j = 0; j < nc; j++ )
+        {
+            double g[4];
+            node[j] = Pi * ( j + 0.5 ) / nc;
+            direct( a + 0.5 * m_segmentDays * ( cos( node[j] ) + 1. ), g );
+            // Unwrap the right ascension (nodes run backward in time)
+            if ( j > 0 )
+            {
+                while ( g[0] - f[j-1] > 12. )
+                {
+                    g[0] -= 24.;
+                }
+                while ( g[0] - f[j-1] < -12. )
+                {
+                    g[0] += 24.;
+                }
+            }
+            for ( int q = 0; q < m_series; q++ )
+            {
+                f[q*nc+j] = g[q];
+            }
+        }
+        // Coefficients
+        double *coef = m_coef + m_series * nc * seg;
+        for ( int q = 0; q < m_series; q++ )
+        {
+            for ( int k = 0; k < nc; k++ )
+            {
+                double sum = 0.;
+                for ( int j = 0; j < nc; j++ )
+                {
+                    sum += f[q*nc+j] * cos( k * node[j] );
+                }
+                coef[q*nc+k] = 2. * sum / nc;
+            }
+        }
+    }
+    delete[] node;
+    delete[] f;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ChebyshevEphemeris destructor.
+ */
+
+ChebyshevEphemeris::~ChebyshevEphemeris( void )
+{
+    delete[] m_coef;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the maximum errors of the fit against the direct
+ *  computation.
+ *
+ *  \param samplesPerDay Number of equally spaced test times per day.
+ *  \param raError Returned maximum right ascension error (seconds of time).
+ *  \param decError Returned maximum declination error (arc seconds).
+ *  \param auxError Returned maximum equation of time error (seconds) for
+ *  the sun, or maximum illuminated fraction error for the moon.
+ */
+
+void ChebyshevEphemeris::accuracy( int samplesPerDay, double *raError,
+        double *decError, double *auxError ) const
+{
+    int n = (int) ( m_segments * m_segmentDays * samplesPerDay );
+    *raError = *decError = *auxError = 0.;
+    for ( int i = 0; i < n; i++ )
+    {
+        double f[4], g[4], aux;
+        double jd = m_start + (double) i / samplesPerDay;
+        direct( jd, g );
+        evaluate( jd, f );
+        double dra = fabs( f[0] - g[0] );
+        if ( dra > 12. )
+        {
+            dra = 24. - dra;
+        }
+        double ddec = fabs( f[1] - g[1] );
+        if ( m_moon )
+        {
+            aux = fabs( f[3] - g[3] );
+        }
+        else
+        {
+            aux = 60. * fabs( EquationOfTime( jd, f[0] )
+                            - EquationOfTime( jd, g[0] ) );
+        }
+        *raError  = ( 3600. * dra > *raError ) ? 3600. * dra : *raError;
+        *decError = ( 3600. * ddec > *decError ) ? 3600. * ddec : *decError;
+        *auxError = ( aux > *auxError ) ? aux : *auxError;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a date is within the fitted span.
+ *
+ *  \param jdate Julian date (GMT).
+ *
+ *  \return TRUE if \a jdate is within the fitted span.
+ */
+
+bool ChebyshevEphemeris::covers( double jdate ) const
+{
+    double d = jdate - m_start;
+    return( d >= 0. && d <= m_segments * m_segmentDays );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the length of the fitted span.
+ *
+ *  \return Length of the fitted span in days (a whole number of segments).
+ */
+
+double ChebyshevEphemeris::days( void ) const
+{
+    return( m_segments * m_segmentDays );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the body's coordinates by the direct computation.
+ *
+ *  \param jdate Julian date (GMT).
+ *  \param f Returned right ascension (hours), declination (degrees), sine
+ *  of declination, and for the moon, illuminated fraction.
+ */
+
+void ChebyshevEphemeris::direct( double jdate, double *f ) const
+{
+    if ( m_moon )
+    {
+        struct CDT_MoonEphemeris eph;
+        CDT_MoonEphemerisInit( &eph, jdate, 0. );
+        f[0] = eph.ra;
+        f[1] = eph.dec;
+        f[2] = eph.sinDec;
+        f[3] = eph.fraction;
+    }
+    else
+    {
+        struct CDT_SunEphemeris eph;
+        CDT_SunEphemerisInit( &eph, jdate, 0. );
+        f[0] = eph.ra;
+        f[1] = eph.dec;
+        f[2] = eph.sinDec;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills a lunar ephemeris from the fit.
+ *
+ *  Equivalent to CDT_MoonEphemerisInit(), for use with
+ *  CDT_MoonPositionEph() and the other site-level routines.
+ *
+ *  \param jdate Julian date-time.
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param eph Pointer to the ephemeris to initialize.
+ *
+ *  \return TRUE if the fit was used, FALSE if this is a solar fit or
+ *  \a jdate is outside the span and the direct computation was used
+ *  instead.
+ */
+
+bool ChebyshevEphemeris::ephemeris( double jdate, double gmtDiff,
+        struct CDT_MoonEphemeris *eph ) const
+{
+    double f[4];
+    if ( ! m_moon || ! evaluate( jdate - gmtDiff / 24., f ) )
+    {
+        CDT_MoonEphemerisInit( eph, jdate, gmtDiff );
+        return( false );
+    }
+    eph->mjd = jdate - 2400000.5 - ( gmtDiff / 24. );
+    eph->ra = f[0];
+    eph->dec = f[1];
+    eph->sinDec = f[2];
+    eph->cosDec = sqrt( 1. - f[2] * f[2] );
+    eph->gmst = CDT_GreenwichSiderealTime( eph->mjd );
+    eph->fraction = f[3];
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills a solar ephemeris from the fit.
+ *
+ *  Equivalent to CDT_SunEphemerisInit(), for use with
+ *  CDT_SunPositionEph(), CDT_SolarRadiationEph(), and the other site-level
+ *  routines.
+ *
+ *  \param jdate Julian date-time.
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param eph Pointer to the ephemeris to initialize.
+ *
+ *  \return TRUE if the fit was used, FALSE if this is a lunar fit or
+ *  \a jdate is outside the span and the direct computation was used
+ *  instead.
+ */
+
+bool ChebyshevEphemeris::ephemeris( double jdate, double gmtDiff,
+        struct CDT_SunEphemeris *eph ) const
+{
+    double f[4];
+    if ( m_moon || ! evaluate( jdate - gmtDiff / 24., f ) )
+    {
+        CDT_SunEphemerisInit( eph, jdate, gmtDiff );
+        return( false );
+    }
+    eph->mjd = jdate - 2400000.5 - ( gmtDiff / 24. );
+    eph->ra = f[0];
+    eph->dec = f[1];
+    eph->sinDec = f[2];
+    eph->cosDec = sqrt( 1. - f[2] * f[2] );
+    eph->gmst = CDT_GreenwichSiderealTime( eph->mjd );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the sun's equation of time.
+ *
+ *  \param jdate Julian date (GMT).
+ *
+ *  \return Equation of time (apparent minus mean solar time) in minutes,
+ *  from the fit for a solar fit, or from the direct computation for a
+ *  lunar fit.
+ */
+
+double ChebyshevEphemeris::equationOfTime( double jdate ) const
+{
+    struct CDT_SunEphemeris eph;
+    ephemeris( jdate, 0., &eph );
+    return( EquationOfTime( jdate, eph.ra ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Evaluates the fitted series.
+ *
+ *  \param jdate Julian date (GMT).
+ *  \param f Returned right ascension (hours [0..24)), declination
+ *  (degrees), sine of declination, and for the moon, illuminated fraction.
+ *
+ *  \return TRUE if the fit was used, FALSE if \a jdate is outside the span
+ *  and the direct computation was used instead.
+ */
+
+bool ChebyshevEphemeris::evaluate( double jdate, double *f ) const
+{
+    double x;
+    const double *coef = segment( jdate, &x );
+    if ( ! coef )
+    {
+        direct( jdate, f );
+        return( false );
+    }
+    int nc = m_order + 1;
+    for ( int q = 0; q < m_series; q++ )
+    {
+        f[q] = series( coef + q * nc, x );
+    }
+    f[0] -= 24. * floor( f[0] / 24. );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if this is a lunar fit.
+ *
+ *  \return TRUE if this is a fit of the moon, FALSE if of the sun.
+ */
+
+bool ChebyshevEphemeris::isMoon( void ) const
+{
+    return( m_moon );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the order of the Chebyshev series.
+ *
+ *  \return Order of the Chebyshev series.
+ */
+
+int ChebyshevEphemeris::order( void ) const
+{
+    return( m_order );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the body's right ascension and declination.
+ *
+ *  \param jdate Julian date (GMT).
+ *  \param ra Returned right ascension (hours, equinox of date).
+ *  \param dec Returned declination (degrees, equinox of date).
+ *
+ *  \return TRUE if the fit was used, FALSE if \a jdate is outside the span
+ *  and the direct computation was used instead.
+ */
+
+bool ChebyshevEphemeris::position( double jdate, double *ra,
+        double *dec ) const
+{
+    double f[4];
+    bool fit = evaluate( jdate, f );
+    *ra = f[0];
+    *dec = f[1];
+    return( fit );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Prints the fit parameters and its accuracy against the direct
+ *  computation to the FILE stream.
+ *
+ *  \param fptr Pointer to an open FILE stream.
+ *  \param samplesPerDay Number of equally spaced test times per day.
+ */
+
+void ChebyshevEphemeris::report( FILE *fptr, int samplesPerDay ) const
+{
+    double raError, decError, auxError;
+    accuracy( samplesPerDay, &raError, &decError, &auxError );
+    fprintf( fptr,
+        "Chebyshev %s ephemeris from jd %1.5f for %1.1f days"
+        " (%d segments of %1.2f days, order %d)\n",
+        m_moon ? "lunar" : "solar",
+        m_start, days(), m_segments, m_segmentDays, m_order );
+    fprintf( fptr,
+        "Maximum error at %d samples/day: RA %1.3e s, Dec %1.3e\","
+        " %s %1.3e%s\n", samplesPerDay, raError, decError,
+        m_moon ? "Fraction" : "EoT", auxError, m_moon ? "" : " s" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the rise or set time of the sun, moon, dawn, or dusk
+ *  from the fitted coordinates.
+ *
+ *  Same as CDT_RiseSet(), except that the 25 hourly altitudes are computed
+ *  from the fit.  Events of the other body, and dates whose local day is not
+ *  entirely within the span, are passed on to CDT_RiseSet().
+ *
+ *  \param event One of the #CDT_Event rise, set, dawn, or dusk values
+ *  accepted by CDT_RiseSet().
+ *  \param jdate Julian date as determined by CDT_JulianDate().
+ *  \param lon Decimal degrees longitude (west GMT is positive).
+ *  \param lat Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param hours Returned decimal hours of the event.
+ *
+ *  \return One of the #CDT_Flag values documented for CDT_RiseSet().
+ *
+ *  \sa CDT_RiseSetSamples().
+ */
+
+int ChebyshevEphemeris::riseSet( int event, double jdate, double lon,
+        double lat, double gmtDiff, double *hours ) const
+{
+    bool moonEvent = ( event == CDT_MoonRise || event == CDT_MoonSet );
+
+    // Modified JD of local midnight adjusted to GMT, as in CDT_RiseSet()
+    int jd = (int) ( jdate - 2400000.5 );
+    double amjd = (double) jd - gmtDiff / 24.;
+    if ( moonEvent != m_moon
+      || ! covers( amjd + 2400000.5 ) || ! covers( amjd + 2400001.5 ) )
+    {
+        return( CDT_RiseSet( event, jdate, lon, lat, gmtDiff, hours ) );
+    }
+    double sphi = sin( Radians * lat );
+    double cphi = cos( Radians * lat );
+    double sinAlt[25];
+    for ( int hour = 0; hour <= 24; hour++ )
+    {
+        double f[4];
+        double mjd = amjd + hour / 24.0;
+        evaluate( mjd + 2400000.5, f );
+        double tau = 15.0 * ( CDT_LocalMeanSiderealTime( mjd, lon ) - f[0] );
+        sinAlt[hour] = sphi * f[2]
+                     + cphi * sqrt( 1. - f[2] * f[2] ) * cos( Radians * tau );
+    }
+    return( CDT_RiseSetSamples( event, sinAlt, hours ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the segment containing a date.
+ *
+ *  \param jdate Julian date (GMT).
+ *  \param x Returned normalized time within the segment [-1..1].
+ *
+ *  \return Pointer to the segment's coefficients, or NULL if \a jdate is
+ *  outside the span.
+ */
+
+const double *ChebyshevEphemeris::segment( double jdate, double *x ) const
+{
+    double d = ( jdate - m_start ) / m_segmentDays;
+    if ( d < 0. || d > m_segments )
+    {
+        return( 0 );
+    }
+    int seg = (int) d;
+    if ( seg == m_segments )
+    {
+        seg--;
+    }
+    *x = 2. * ( d - seg ) - 1.;
+    return( m_coef + m_series * ( m_order + 1 ) * seg );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Evaluates a Chebyshev series by Clenshaw's recurrence.
+ *
+ *  \param coef Array of m_order+1 coefficients.
+ *  \param x Normalized time [-1..1].
+ *
+ *  \return Value of the series at \a x.
+ */
+
+double ChebyshevEphemeris::series( const double *coef, double x ) const
+{
+    double b0 = 0.;
+    double b1 = 0.;
+    double b2 = 0.;
+    double x2 = 2. * x;
+    for ( int k = m_order; k >= 1; k-- )
+    {
+        b2 = b1;
+        b1 = b0;
+        b0 = x2 * b1 - b2 + coef[k];
+    }
+    return( x * b0 - b1 + 0.5 * coef[0] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of segments in the span.
+ *
+ *  \return Number of segments in the span.
+ */
+
+int ChebyshevEphemeris::segments( void ) const
+{
+    return( m_segments );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the start of the fitted span.
+ *
+ *  \return Julian date (GMT) of the start of the fitted span.
+ */
+
+double ChebyshevEphemeris::start( void ) const
+{
+    return( m_start );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares riseSet() against CDT_RiseSet() for every local day in
+ *  the span at one site.
+ *
+ *  The moon rise and set are compared for a lunar fit, and the sun rise and
+ *  set and all three twilights for a solar fit.
+ *
+ *  \param lon Decimal degrees longitude (west GMT is positive).
+ *  \param lat Decimal degrees latitude (north equator is positive).
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param maxMinutes Returned maximum difference in minutes between event
+ *  times for which both return the same flag.
+ *  \param mismatches Returned number of events for which the flags differ.
+ *
+ *  \return Number of events compared.
+ */
+
+int ChebyshevEphemeris::verifyRiseSet( double lon, double lat,
+        double gmtDiff, double *maxMinutes, int *mismatches ) const
+{
+    static const int SunEvent[] = { CDT_SunRise, CDT_SunSet, CDT_CivilDawn,
+        CDT_CivilDusk, CDT_NauticalDawn, CDT_NauticalDusk,
+        CDT_AstronomicalDawn, CDT_AstronomicalDusk };
+    static const int MoonEvent[] = { CDT_MoonRise, CDT_MoonSet };
+    const int *events = m_moon ? MoonEvent : SunEvent;
+    int nEvents = m_moon ? 2 : 8;
+    int compared = 0;
+    *maxMinutes = 0.;
+    *mismatches = 0;
+
+    // Every local date whose day lies entirely within the span
+    for ( int day = (int) ( m_start - 2400000.5 ); ; day++ )
+    {
+        double amjd = day - gmtDiff / 24.;
+        if ( amjd + 2400001.5 > m_start + days() )
+        {
+            break;
+        }
+        if ( amjd + 2400000.5 < m_start )
+        {
+            continue;
+        }
+        double jdate = day + 2400000.5;
+        for ( int e = 0; e < nEvents; e++ )
+        {
+            double fit, ref;
+            int ff = riseSet( events[e], jdate, lon, lat, gmtDiff, &fit );
+            int rf = CDT_RiseSet( events[e], jdate, lon, lat, gmtDiff, &ref );
+            compared++;
+            if ( ff != rf )
+            {
+                ( *mismatches )++;
+            }
+            else if ( ( rf == CDT_Rises || rf == CDT_Sets )
+                && 60. * fabs( fit - ref ) > *maxMinutes )
+            {
+                *maxMinutes = 60. * fabs( fit - ref );
+            }
+        }
+    }
+    return( compared );
+}
+
+//------------------------------------------------------------------------------
+//  End of chebyshev.cpp
+//------------------------------------------------------------------------------
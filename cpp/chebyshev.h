@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*! \file chebyshev.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Chebyshev polynomial ephemeris C++ API header.
+ *
+ *  The ChebyshevEphemeris class fits the Calendar-Date-Time Library solar
+ *  or lunar coordinates in cdtlib.c over a span of days.
+ */
+
+#ifndef _CHEBYSHEV_H_
+/*! \def _CHEBYSHEV_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _CHEBYSHEV_H_ 1
+
+// Forward structure references
+struct CDT_MoonEphemeris;
+struct CDT_SunEphemeris;
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \class ChebyshevEphemeris chebyshev.h
+ *
+ *  \brief Solar or lunar right ascension and declination as piecewise
+ *  Chebyshev polynomials of time.
+ *
+ *  The span is divided into equal segments.  On each segment the body's
+ *  right ascension (unwrapped across 0h), declination, and sine of
+ *  declination from CDT_SunEphemerisInit() or CDT_MoonEphemerisInit() (and
+ *  for the moon, its illuminated fraction) are sampled at the Chebyshev
+ *  nodes and interpolated by a Chebyshev series.  Each evaluation is then a
+ *  segment lookup and a Clenshaw recurrence of a dozen multiply-adds per
+ *  quantity, instead of CDT_MiniSun()'s sines, arctangents, and square
+ *  root, or CDT_MiniMoon()'s twenty-odd perturbation terms.
+ *
+ *  For the sun, the equation of time is derived from the fitted right
+ *  ascension and the sun's mean longitude (which is linear in time), so it
+ *  needs no series of its own.
+ *
+ *  riseSet() finds rise, set, and twilight times from the fitted altitude
+ *  curve using CDT_RiseSetSamples(), so a lunar fit replaces the 25
+ *  CDT_MiniMoon() evaluations per site-day of CDT_RiseSet().
+ *
+ *  Dates outside the span fall back to the direct computation.  Use
+ *  accuracy() or report() to verify a fit against the direct computation,
+ *  and verifyRiseSet() to verify rise and set times against CDT_RiseSet().
+ *
+ *  With the default segments over 2023 through 2026, verifyRiseSet() at
+ *  sites from 85N to 85S finds every event flag identical to CDT_RiseSet()
+ *  and every time within 0.001 minutes, which is the regression tolerance
+ *  checked by tests/chebyshevtest.cpp.
+ */
+
+class ChebyshevEphemeris
+{
+// Public methods
+public:
+    ChebyshevEphemeris( double jdate, double days, bool moon=false,
+        double segmentDays=0., int order=0 ) ;
+    ~ChebyshevEphemeris( void ) ;
+
+    void     accuracy( int samplesPerDay, double *raError, double *decError,
+                double *auxError ) const ;
+    bool     covers( double jdate ) const ;
+    double   days( void ) const ;
+    bool     ephemeris( double jdate, double gmtDiff,
+                struct CDT_MoonEphemeris *eph ) const ;
+    bool     ephemeris( double jdate, double gmtDiff,
+                struct CDT_SunEphemeris *eph ) const ;
+    double   equationOfTime( double jdate ) const ;
+    bool     isMoon( void ) const ;
+    int      order( void ) const ;
+    bool     position( double jdate, double *ra, double *dec ) const ;
+    void     report( FILE *fptr, int samplesPerDay=24 ) const ;
+    int      riseSet( int event, double jdate, double lon, double lat,
+                double gmtDiff, double *hours ) const ;
+    int      segments( void ) const ;
+    double   start( void ) const ;
+    int      verifyRiseSet( double lon, double lat, double gmtDiff,
+                double *maxMinutes, int *mismatches ) const ;
+
+// Private methods
+private:
+    ChebyshevEphemeris( const ChebyshevEphemeris &ce ) ;
+    ChebyshevEphemeris &operator=( const ChebyshevEphemeris &ce ) ;
+    void     direct( double jdate, double *f ) const ;
+    bool     evaluate( double jdate, double *f ) const ;
+    const double *segment( double jdate, double *x ) const ;
+    double   series( const double *coef, double x ) const ;
+
+// Protected member data
+protected:
+    /*! \var bool m_moon
+        \brief TRUE if the fit is of the moon, FALSE if of the sun.
+    */
+    bool    m_moon;
+    /*! \var int m_series
+        \brief Number of series per segment (3 for the sun, 4 for the moon).
+    */
+    int     m_series;
+    /*! \var double m_start
+        \brief Julian date (GMT) of the start of the span.
+    */
+    double  m_start;
+    /*! \var double m_segmentDays
+        \brief Length of each segment in days.
+    */
+    double  m_segmentDays;
+    /*! \var int m_segments
+        \brief Number of segments in the span.
+    */
+    int     m_segments;
+    /*! \var int m_order
+        \brief Order of each Chebyshev series (m_order+1 coefficients).
+    */
+    int     m_order;
+    /*! \var double *m_coef
+        \brief Coefficients of the right ascension, declination, sine of
+        declination, and (for the moon) illuminated fraction series for each
+        segment, in that order.
+    */
+    double *m_coef;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of chebyshev.h
+//------------------------------------------------------------------------------
@@ -13,6 +13,8 @@
 #include "cdtlib.h"
 #include "datetime.h"
 #include "globalposition.h"
+#include "systemclock.h"
+#include "timestamp.h"
 
 // Standard include files
 #include <math.h>
@@ -57,11 +59,11 @@ DateTime::DateTime( int year, int month, int day, int hour, int minute,
     m_second(second),
     m_millisecond(millisecond),
     m_event(CDT_User),
-    m_flag(CDT_None)
+    m_flag(CDT_None),
+    m_dirty(JulianDateDirty|FlagDirty)
 {
-    // Update
-    calculateJulianDate();
-    isValid();      // At least set the flag even tho we can't return it
+    // The Julian date and flag are calculated when first needed
+    m_jdate = 0.;
     return;
 }
 
@@ -81,7 +83,8 @@ DateTime::DateTime( DateTime &dt ) :
     m_second(dt.m_second),
     m_millisecond(dt.m_millisecond),
     m_event(dt.m_event),
-    m_flag(dt.m_flag)
+    m_flag(dt.m_flag),
+    m_dirty(dt.m_dirty)
 {
     return;
 }
@@ -101,11 +104,12 @@ DateTime::DateTime( DateTime &dt ) :
 
 bool DateTime::addDays( double days )
 {
+    updateJulianDate();
     m_jdate += days;
     // Update
     m_event = CDT_User;
-    calculateJulianDate();
-    return( isValid() );
+    julianDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -268,18 +272,47 @@ bool DateTime::astronomicalDusk( const GlobalPosition &gp )
  *  \warning No date or time validation is performed before the calendar
  *  date and time is calculated.
  *
- *  \return TRUE if the resulting DateTime is valid,
- *  FALSE if the resulting DateTime is invalid.
- *  The invalid data member can be determined from the flag() return code.
+ *  \return The function returns nothing.  On return the calendar fields are
+ *  current.
  *
- *  \sa CDT_CalendarDate().
+ *  \sa CDT_CalendarDate(), updateCalendarDate().
  */
 
-bool DateTime::calculateCalendarDate( void )
+void DateTime::calculateCalendarDate( void ) const
 {
     CDT_CalendarDate( m_jdate, &m_year, &m_month, &m_day,
         &m_hour, &m_minute, &m_second, &m_millisecond );
-    return( isValid() );
+    m_dirty &= ~CalendarDateDirty;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates the DateTime #m_flag validation code.
+ *
+ *  If the calendar fields are current they are validated by
+ *  CDT_ValidDateTime().  Otherwise the fields will be derived from #m_jdate
+ *  and can only be out of range before Jan 1, -4712, so just the Julian day
+ *  number is checked and the calendar conversion is still deferred.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTime::calculateFlag( void ) const
+{
+    if ( m_dirty & CalendarDateDirty )
+    {
+        long jdn;
+        int ms;
+        CDT_JulianDateSplit( m_jdate, &jdn, &ms );
+        m_flag = ( jdn >= 0 ) ? CDT_HasValidDateTime : CDT_HasInvalidYear;
+    }
+    else
+    {
+        m_flag = CDT_ValidDateTime( m_year, m_month, m_day,
+            m_hour, m_minute, m_second, m_millisecond );
+    }
+    m_dirty &= ~FlagDirty;
+    return;
 }
 
 //------------------------------------------------------------------------------
@@ -288,22 +321,23 @@ bool DateTime::calculateCalendarDate( void )
  *
  *  Calls CDT_JulianDate() to perform the actual computations.
  *
- *  \return The Julian date in decimal days since 1 Jan -4712.  On return the
- *  #m_jdate data member is updated.
+ *  \return The function returns nothing.  On return the #m_jdate data member
+ *  is current.
  *
- *  \sa CDT_JulianDate().
+ *  \sa CDT_JulianDate(), updateJulianDate().
  */
 
-double DateTime::calculateJulianDate( void )
+void DateTime::calculateJulianDate( void ) const
 {
     m_jdate = CDT_JulianDate( m_year, m_month, m_day,
         m_hour, m_minute, m_second, m_millisecond );
-    return( m_jdate );
+    m_dirty &= ~JulianDateDirty;
+    return;
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Calculates the calendar date-time of an equinox or solstice
- *  #CDT_Event for the current DateTime year.
+ *  #CDT_Event for the \a year.
  *
  *  Calls #CDT_SolsticeGMT() to perform the computation.
  *
@@ -312,6 +346,7 @@ double DateTime::calculateJulianDate( void )
  *  \arg #CDT_Summer for the summer (June) solstice date and time,
  *  \arg #CDT_Fall for the fall (September) equinox date and time, or
  *  \arg #CDT_Winter for the winter (December) solstice date and time.
+ *  \param year Julian-Gregorian year (-4712 or later).
  *  \param gp Reference to an existing GlobalPosition instance.
  *
  *  \return TRUE if the resulting DateTime is valid,
@@ -319,17 +354,19 @@ double DateTime::calculateJulianDate( void )
  *  The invalid data member can be determined from the flag() return code.
  */
 
-bool DateTime::calculateSolstice( int event, const GlobalPosition &gp )
+bool DateTime::calculateSolstice( int event, int year,
+        const GlobalPosition &gp )
 {
     // Determine GMT Julian date of the event
-    m_jdate = CDT_SolsticeGMT( event, m_year );
+    m_jdate = CDT_SolsticeGMT( event, year );
 
     // Add time zone difference from GMT
-    m_jdate += (gp.gmtDiff() / 24.);
+    m_jdate += (gp.gmtDiffAtGMT( m_jdate ) / 24.);
 
-    // Update (m_flag must be set by the caller)
-    calculateCalendarDate();
-    return( isValid() );
+    // Update
+    m_event = event;
+    julianDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -361,25 +398,63 @@ bool DateTime::calculateSunTime( int event, const GlobalPosition &gp )
 {
     // Get the local rise/set time of this event and save the flag
     double hours = 0.0;
-    int flag = CDT_RiseSet( (int) event, m_jdate, gp.longitude(),
-        gp.latitude(), gp.gmtDiff(), &hours );
+    updateJulianDate();
+    // Use the time zone offset in effect at local noon of the date
+    double gmtDiff = gp.gmtDiffAt( floor( m_jdate - 0.5 ) + 1.0 );
+    int riseSetFlag = CDT_RiseSet( (int) event, m_jdate, gp.longitude(),
+        gp.latitude(), gmtDiff, &hours );
 
     // Add the event time to the Julian date
     m_jdate += ( hours / 24. );
 
     // Update the calendar
     m_event = event;
-    calculateCalendarDate();
-    if ( ! isValid() )
+    julianDateChanged();
+    if ( flag() != CDT_HasValidDateTime )
     {
         return( false );
     }
 
     // Since the validation routine updates m_flag, set it back again.
-    m_flag = flag;
+    m_flag = riseSetFlag;
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Marks the Julian date and validation flag as stale after one or
+ *  more calendar fields have been stored.
+ *
+ *  The caller must have made all the calendar fields current (see
+ *  updateCalendarDate()) before storing a subset of them.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTime::calendarDateChanged( void )
+{
+    m_dirty = JulianDateDirty | FlagDirty;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Normalizes the calendar fields by recalculating them from the
+ *  Julian date, then validates them.
+ *
+ *  Out-of-range fields stored by the setters (such as day 32) roll over
+ *  into the adjacent month, hour, etc.
+ *
+ *  \return TRUE if the resulting DateTime is valid,
+ *  FALSE if the resulting DateTime is invalid.
+ *  The invalid data member can be determined from the flag() return code.
+ */
+
+bool DateTime::checkCalendarDate( void )
+{
+    updateJulianDate();
+    calculateCalendarDate();
+    return( isValid() );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines the time of civil dawn for the current DateTime
  *  #m_year, #m_month, and #m_day.
@@ -468,6 +543,7 @@ bool DateTime::civilDusk( const GlobalPosition &gp )
 
 int DateTime::day( void ) const
 {
+    updateCalendarDate();
     return( m_day );
 }
 
@@ -482,12 +558,38 @@ int DateTime::day( void ) const
 
 int DateTime::day( int newDay )
 {
+    updateCalendarDate();
     m_day = newDay;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_day );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Determines the length of daylight for the current DateTime
+ *  #m_year, #m_month, and #m_day.
+ *
+ *  Calls #CDT_SolarDay() to perform the calculation, which evaluates the
+ *  sun's position once instead of the two rise/set scans of sunRise() and
+ *  sunSet().  The DateTime is not changed.
+ *
+ *  \param gp Reference to a GlobalPosition or GlobalSite object.
+ *
+ *  \return Hours from sunrise to sunset, 0 for polar night, or 24 for
+ *  polar day.
+ *
+ *  \sa sunRise(), sunSet().
+ */
+
+double DateTime::dayLength( const GlobalPosition &gp ) const
+{
+    double transit, dayLength, maxAltitude, declination;
+    double jdate = julianDate();
+    CDT_SolarDay( jdate, gp.longitude(), gp.latitude(),
+        gp.gmtDiffAt( floor( jdate - 0.5 ) + 1.0 ),
+        &transit, &dayLength, &maxAltitude, &declination );
+    return( dayLength );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief detrmines the day-of-the-week index for the current DateTime
  *  #m_year, #m_month, and #m_day.
@@ -505,7 +607,7 @@ int DateTime::day( int newDay )
 
 int DateTime::dayOfWeek( void ) const
 {
-    return( CDT_DayOfWeek( m_jdate ) );
+    return( CDT_DayOfWeek( julianDate() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -554,6 +656,7 @@ const char *DateTime::dayOfWeekName( void ) const
 
 int DateTime::dayOfYear( void ) const
 {
+    updateCalendarDate();
     return( CDT_DayOfYear( m_year, m_month, m_day ) );
 }
 
@@ -571,6 +674,7 @@ int DateTime::dayOfYear( void ) const
 
 int DateTime::daysInMonth( void ) const
 {
+    updateCalendarDate();
     return( CDT_DaysInMonth( m_year, m_month ) );
 }
 
@@ -587,7 +691,7 @@ int DateTime::daysInMonth( void ) const
 
 int DateTime::daysInYear( void ) const
 {
-    return( CDT_DaysInYear( m_year ) );
+    return( CDT_DaysInYear( year() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -605,7 +709,7 @@ int DateTime::daysInYear( void ) const
 
 double DateTime::daysSince( const DateTime &dt ) const
 {
-    return( m_jdate - dt.m_jdate );
+    return( julianDate() - dt.julianDate() );
 }
 
 //------------------------------------------------------------------------------
@@ -623,7 +727,7 @@ double DateTime::daysSince( const DateTime &dt ) const
 
 double DateTime::daysUntil( const DateTime &dt ) const
 {
-    return( dt.m_jdate - m_jdate );
+    return( dt.julianDate() - julianDate() );
 }
 
 //------------------------------------------------------------------------------
@@ -637,6 +741,7 @@ double DateTime::daysUntil( const DateTime &dt ) const
 
 double DateTime::decimalDay( void ) const
 {
+    updateCalendarDate();
     return( CDT_DecimalDay( m_hour, m_minute, m_second, m_millisecond ) ) ;
 }
 
@@ -651,6 +756,7 @@ double DateTime::decimalDay( void ) const
 
 double DateTime::decimalHour( void ) const
 {
+    updateCalendarDate();
     return( CDT_DecimalHour( m_hour, m_minute, m_second, m_millisecond ) ) ;
 }
 
@@ -677,7 +783,13 @@ double DateTime::decimalHour( void ) const
 bool DateTime::easter( int year )
 {
     m_year = year;
-    return( easter() );
+    CDT_EasterDay( m_year, &m_month, &m_day );
+    m_hour = 12;
+    m_minute = m_second = m_millisecond = 0;
+    // Update
+    m_event = CDT_Easter;
+    calendarDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -699,13 +811,7 @@ bool DateTime::easter( int year )
 
 bool DateTime::easter( void )
 {
-    CDT_EasterDay( m_year, &m_month, &m_day );
-    m_hour = 12;
-    m_minute = m_second = m_millisecond = 0;
-    // Update
-    calculateJulianDate();
-    m_event = CDT_Easter;
-    return( isValid() );
+    return( easter( year() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -749,8 +855,7 @@ const char *DateTime::eventName( void ) const
 
 bool DateTime::fallEquinox( int year, const GlobalPosition &gp )
 {
-    m_year = year;
-    return( fallEquinox( gp ) );
+    return( calculateSolstice( CDT_Fall, year, gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -769,8 +874,7 @@ bool DateTime::fallEquinox( int year, const GlobalPosition &gp )
 
 bool DateTime::fallEquinox( const GlobalPosition &gp )
 {
-    calculateSolstice( (m_event = CDT_Fall), gp );
-    return( isValid() );
+    return( calculateSolstice( CDT_Fall, year(), gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -782,6 +886,7 @@ bool DateTime::fallEquinox( const GlobalPosition &gp )
 
 int DateTime::flag( void ) const
 {
+    updateFlag();
     return( m_flag );
 }
 
@@ -795,7 +900,7 @@ int DateTime::flag( void ) const
 
 const char *DateTime::flagName( void ) const
 {
-    return( CDT_FlagName( m_flag ) );
+    return( CDT_FlagName( flag() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -818,17 +923,17 @@ const char *DateTime::flagName( void ) const
 
 bool DateTime::fullMoon( int period, const GlobalPosition &gp )
 {
-    int l_year = m_year;
-    newMoon( period, gp );
+    int l_year = year();
+    newMoon( l_year, period, gp );
     double date0 = m_jdate;
     newMoon( l_year, period+1, gp );
     double date1 = m_jdate;
     m_jdate = 0.5 * (date0 + date1);
 
     // Update
-    calculateCalendarDate();
     m_event = CDT_FullMoon;
-    return( isValid() );
+    julianDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -839,6 +944,7 @@ bool DateTime::fullMoon( int period, const GlobalPosition &gp )
 
 int DateTime::hour( void ) const
 {
+    updateCalendarDate();
     return( m_hour );
 }
 
@@ -853,9 +959,9 @@ int DateTime::hour( void ) const
 
 int DateTime::hour( int newHour )
 {
+    updateCalendarDate();
     m_hour = newHour;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_hour );
 }
 
@@ -874,7 +980,7 @@ int DateTime::hour( int newHour )
 
 double DateTime::hoursSince( const DateTime &dt ) const
 {
-    return( 24. * (m_jdate - dt.m_jdate) );
+    return( 24. * (julianDate() - dt.julianDate()) );
 }
 
 //------------------------------------------------------------------------------
@@ -891,7 +997,7 @@ double DateTime::hoursSince( const DateTime &dt ) const
  */
 double DateTime::hoursUntil( const DateTime &dt ) const
 {
-    return( 24. * (dt.m_jdate - m_jdate) );
+    return( 24. * (dt.julianDate() - julianDate()) );
 }
 
 //------------------------------------------------------------------------------
@@ -904,7 +1010,7 @@ double DateTime::hoursUntil( const DateTime &dt ) const
 
 int DateTime::isLeapYear( void ) const
 {
-    return( CDT_LeapYear( m_year ) );
+    return( CDT_LeapYear( year() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -929,6 +1035,8 @@ int DateTime::isLeapYear( void ) const
 
 bool DateTime::isValid( void )
 {
+    updateCalendarDate();
+    m_dirty &= ~FlagDirty;
     if ( ( m_flag =
             CDT_ValidDateTime( m_year, m_month, m_day,
                 m_hour, m_minute, m_second, m_millisecond ) )
@@ -957,6 +1065,8 @@ bool DateTime::isValid( void )
 
 bool DateTime::isValidDate( void )
 {
+    updateCalendarDate();
+    m_dirty &= ~FlagDirty;
     if ( ( m_flag =
             CDT_ValidDate( m_year, m_month, m_day ) )
         != CDT_HasValidDate )
@@ -985,6 +1095,8 @@ bool DateTime::isValidDate( void )
 
 bool DateTime::isValidTime( void )
 {
+    updateCalendarDate();
+    m_dirty &= ~FlagDirty;
     if ( ( m_flag =
             CDT_ValidTime( m_hour, m_minute, m_second, m_millisecond ) )
         != CDT_HasValidTime )
@@ -1003,9 +1115,23 @@ bool DateTime::isValidTime( void )
 
 double DateTime::julianDate( void ) const
 {
+    updateJulianDate();
     return( m_jdate );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Marks the calendar fields and validation flag as stale after the
+ *  #m_jdate Julian date has been stored.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTime::julianDateChanged( void )
+{
+    m_dirty = CalendarDateDirty | FlagDirty;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Gets the value of the DateTime millisecond of the second.
  *
@@ -1014,6 +1140,7 @@ double DateTime::julianDate( void ) const
 
 int DateTime::millisecond( void ) const
 {
+    updateCalendarDate();
     return( m_millisecond );
 }
 
@@ -1028,9 +1155,9 @@ int DateTime::millisecond( void ) const
 
 int DateTime::millisecond( int newMillisecond )
 {
+    updateCalendarDate();
     m_millisecond = newMillisecond;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_millisecond );
 }
 
@@ -1043,6 +1170,7 @@ int DateTime::millisecond( int newMillisecond )
 
 int DateTime::millisecondOfDay( void ) const
 {
+    updateCalendarDate();
     return( CDT_MillisecondOfDay( m_hour, m_minute, m_second, m_millisecond ) );
 }
 
@@ -1054,6 +1182,7 @@ int DateTime::millisecondOfDay( void ) const
 
 int DateTime::minute( void ) const
 {
+    updateCalendarDate();
     return( m_minute );
 }
 
@@ -1068,9 +1197,9 @@ int DateTime::minute( void ) const
 
 int DateTime::minute( int newMinute )
 {
+    updateCalendarDate();
     m_minute = newMinute;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_minute );
 }
 
@@ -1083,7 +1212,7 @@ int DateTime::minute( int newMinute )
 
 double DateTime::modifiedJulianDate( void ) const
 {
-    return( CDT_ModifiedJulianDate( m_jdate ) );
+    return( CDT_ModifiedJulianDate( julianDate() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1094,6 +1223,7 @@ double DateTime::modifiedJulianDate( void ) const
 
 int DateTime::month( void ) const
 {
+    updateCalendarDate();
     return( m_month );
 }
 
@@ -1108,9 +1238,9 @@ int DateTime::month( void ) const
 
 int DateTime::month( int newMonth )
 {
+    updateCalendarDate();
     m_month = newMonth;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_month );
 }
 
@@ -1126,7 +1256,7 @@ int DateTime::month( int newMonth )
 
 const char *DateTime::monthAbbreviation( void ) const
 {
-    return( CDT_MonthAbbreviation( m_month ) );
+    return( CDT_MonthAbbreviation( month() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1140,7 +1270,7 @@ const char *DateTime::monthAbbreviation( void ) const
 
 const char *DateTime::monthName( void ) const
 {
-    return( CDT_MonthName( m_month ) );
+    return( CDT_MonthName( month() ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1319,8 +1449,14 @@ bool DateTime::nauticalDusk( const GlobalPosition &gp )
 
 bool DateTime::newMoon( int year, int period, const GlobalPosition &gp )
 {
-    m_year = year;
-    return( newMoon( period, gp ) );
+    // Get new moon GMT and adjust to local time
+    double gmt = CDT_NewMoonGMT( year, period );
+    m_jdate = gmt + ( gp.gmtDiffAtGMT( gmt ) / 24. );
+
+    // Update
+    m_event = CDT_NewMoon;
+    julianDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -1350,13 +1486,7 @@ bool DateTime::newMoon( int year, int period, const GlobalPosition &gp )
 
 bool DateTime::newMoon( int period, const GlobalPosition &gp )
 {
-    // Get new moon GMT and adjust to local time
-    m_jdate = CDT_NewMoonGMT( m_year, period) + ( gp.gmtDiff() / 24. );
-
-    // Update
-    calculateCalendarDate();
-    m_event = CDT_NewMoon;
-    return( isValid() );
+    return( newMoon( year(), period, gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1371,9 +1501,9 @@ void DateTime::print( FILE *fptr ) const
 {
     fprintf( fptr,
         "%s is %s %s %02d, %04d (%03d) at %02d:%02d:%02d.%03d %s [jd %1.9f]\n",
-        eventName(), dayOfWeekAbbreviation(), monthAbbreviation(), m_day,
-        m_year, dayOfYear(), m_hour, m_minute, m_second, m_millisecond,
-        flagName(), m_jdate );
+        eventName(), dayOfWeekAbbreviation(), monthAbbreviation(), day(),
+        year(), dayOfYear(), hour(), minute(), second(), millisecond(),
+        flagName(), julianDate() );
     return;
 }
 
@@ -1385,6 +1515,7 @@ void DateTime::print( FILE *fptr ) const
 
 int DateTime::second( void ) const
 {
+    updateCalendarDate();
     return( m_second );
 }
 
@@ -1399,9 +1530,9 @@ int DateTime::second( void ) const
 
 int DateTime::second( int newSecond )
 {
+    updateCalendarDate();
     m_second = newSecond;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_second );
 }
 
@@ -1418,7 +1549,8 @@ int DateTime::second( int newSecond )
 bool DateTime::set( double julianDate )
 {
     m_jdate = julianDate;
-    return( calculateCalendarDate() );
+    julianDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -1451,38 +1583,83 @@ bool DateTime::set( int year, int month, int day, int hour, int minute,
 
     // Update
     m_event = CDT_User;
-    calculateJulianDate();
-    return( isValid() );
+    calendarDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Sets all the data members of the DateTime to the current system
  *  clock values.
  *
+ *  The clock is read to the millisecond by SystemClock, and converted to
+ *  the system's local time with the reentrant localtime_r() (localtime_s()
+ *  on Windows), so it is safe to call from several threads.
+ *
  *  \return TRUE if the resulting DateTime is valid,
  *  FALSE if the resulting DateTime is invalid.
  *  The invalid data member can be determined from the flag() return code.
+ *
+ *  \sa setSystem( const GlobalPosition &gp )
  */
 
 bool DateTime::setSystem( void )
 {
     // Get the current system date and time
-    time_t now = time( (time_t *) NULL );
-    struct tm *t = localtime( &now );
+    long long ms = SystemClock::milliseconds() - SystemClock::UnixEpoch;
+    time_t now = (time_t) ( ms / 1000 );
+    struct tm t;
+#if defined(_WIN32)
+    localtime_s( &t, &now );
+#else
+    localtime_r( &now, &t );
+#endif
 
     // Store in the DateTime
-    m_year          = t->tm_year + 1900;
-    m_month         = t->tm_mon + 1;
-    m_day           = t->tm_mday;
-    m_hour          = t->tm_hour;
-    m_minute        = t->tm_min;
-    m_second        = t->tm_sec;
-    m_millisecond   = 0;
+    m_year          = t.tm_year + 1900;
+    m_month         = t.tm_mon + 1;
+    m_day           = t.tm_mday;
+    m_hour          = t.tm_hour;
+    m_minute        = t.tm_min;
+    m_second        = t.tm_sec;
+    m_millisecond   = (int) ( ms % 1000 );
 
     // Update
     m_event = CDT_System;
-    calculateJulianDate();
-    return( isValid() );
+    calendarDateChanged();
+    return( flag() == CDT_HasValidDateTime );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets all the data members of the DateTime to the current system
+ *  clock values in the local time of a GlobalPosition.
+ *
+ *  The local time difference is taken from GlobalPosition::gmtDiffAtGMT(),
+ *  so no C library time zone state is used at all.
+ *
+ *  \param gp Reference to a GlobalPosition or GlobalSite object.
+ *
+ *  \return TRUE if the resulting DateTime is valid,
+ *  FALSE if the resulting DateTime is invalid.
+ *  The invalid data member can be determined from the flag() return code.
+ *
+ *  \sa setSystem()
+ */
+
+bool DateTime::setSystem( const GlobalPosition &gp )
+{
+    // Get the current GMT and shift it to local time
+    TimeStamp ts = SystemClock::timeStamp();
+    ts.addMilliseconds(
+        (long long) floor( gp.gmtDiffAtGMT( ts.julianDate() ) * 3600000. + 0.5 ) );
+
+    // Store in the DateTime
+    ts.calendarDate( &m_year, &m_month, &m_day,
+        &m_hour, &m_minute, &m_second, &m_millisecond );
+
+    // Update
+    m_event = CDT_System;
+    calendarDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -1500,6 +1677,7 @@ bool DateTime::setSystem( void )
 
 bool DateTime::setTime( int hour, int minute, int second, int millisecond )
 {
+    updateCalendarDate();
     if ( hour >= 0 )
     {
         m_hour = hour;
@@ -1519,8 +1697,8 @@ bool DateTime::setTime( int hour, int minute, int second, int millisecond )
 
     // Update
     m_event = CDT_User;
-    calculateJulianDate();
-    return( isValid() );
+    calendarDateChanged();
+    return( flag() == CDT_HasValidDateTime );
 }
 
 //------------------------------------------------------------------------------
@@ -1539,8 +1717,7 @@ bool DateTime::setTime( int hour, int minute, int second, int millisecond )
 
 bool DateTime::springEquinox( int year, const GlobalPosition &gp )
 {
-    m_year = year;
-    return( springEquinox( gp ) );
+    return( calculateSolstice( CDT_Spring, year, gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1557,10 +1734,9 @@ bool DateTime::springEquinox( int year, const GlobalPosition &gp )
  *  equinox for \a year, and event() returns #CDT_Spring.
  */
 
-bool DateTime::springEquinox( const GlobalPosition &gp)
+bool DateTime::springEquinox( const GlobalPosition &gp )
 {
-    calculateSolstice( (m_event = CDT_Spring), gp );
-    return( isValid() );
+    return( calculateSolstice( CDT_Spring, year(), gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1579,8 +1755,7 @@ bool DateTime::springEquinox( const GlobalPosition &gp)
 
 bool DateTime::summerSolstice( int year, const GlobalPosition &gp )
 {
-    m_year = year;
-    return( summerSolstice( gp ) );
+    return( calculateSolstice( CDT_Summer, year, gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1599,8 +1774,7 @@ bool DateTime::summerSolstice( int year, const GlobalPosition &gp )
 
 bool DateTime::summerSolstice( const GlobalPosition &gp )
 {
-    calculateSolstice( (m_event = CDT_Summer), gp );
-    return( isValid() );
+    return( calculateSolstice( CDT_Summer, year(), gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1691,8 +1865,7 @@ bool DateTime::sunSet( const GlobalPosition &gp )
 
 bool DateTime::winterSolstice( int year, const GlobalPosition &gp )
 {
-    m_year = year;
-    return( winterSolstice( gp ) );
+    return( calculateSolstice( CDT_Winter, year, gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1709,10 +1882,9 @@ bool DateTime::winterSolstice( int year, const GlobalPosition &gp )
  *  solstice for \a year, and event() returns #CDT_Winter.
  */
 
-bool DateTime::winterSolstice( const GlobalPosition &gp)
+bool DateTime::winterSolstice( const GlobalPosition &gp )
 {
-    calculateSolstice( (m_event = CDT_Winter), gp );
-    return( isValid() );
+    return( calculateSolstice( CDT_Winter, year(), gp ) );
 }
 
 //------------------------------------------------------------------------------
@@ -1723,6 +1895,7 @@ bool DateTime::winterSolstice( const GlobalPosition &gp)
 
 int DateTime::year( void ) const
 {
+    updateCalendarDate();
     return( m_year );
 }
 
@@ -1737,9 +1910,9 @@ int DateTime::year( void ) const
 
 int DateTime::year( int newYear )
 {
+    updateCalendarDate();
     m_year = newYear;
-    calculateJulianDate();
-    isValid();
+    calendarDateChanged();
     return( m_year );
 }
 
@@ -1762,6 +1935,7 @@ DateTime &DateTime::operator=( const DateTime &dt )
     m_millisecond   = dt.m_millisecond;
     m_event         = dt.m_event;
     m_flag          = dt.m_flag;
+    m_dirty         = dt.m_dirty;
     return( *this );
 }
 
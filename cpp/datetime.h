@@ -28,11 +28,27 @@ class GlobalPosition;
  *  The DateTime class is a C++ wrapper for the calendar, date, and time
  *  functions in the CDT library (cdtlib.c).
  *
+ *  A DateTime holds both a Julian date and the broken-down calendar fields,
+ *  but only one of them need be current.  Setters update whichever
+ *  representation they were given and mark the other one (and the validity
+ *  flag) dirty; the stale representation is recomputed on its first read.
+ *  Setting several fields in a row therefore costs nothing until the
+ *  Julian date, a derived quantity, or flag() is requested.
+ *
+ *  Because that recomputation writes the mutable members from const
+ *  getters, const access is \e not read-only, and concurrent reads of one
+ *  DateTime from several threads race.  Give each thread its own copy, or
+ *  guard the shared instance with a lock.  Calling julianDate(), year(), and
+ *  flag() once clears every dirty bit, after which const reads no longer
+ *  write until the next setter.
+ *
  *  \sa cdtlib.c
  */
 
 class DateTime
 {
+    friend class TimeStamp;
+
 // Public constructor methods
 public:
     DateTime( void ) ;
@@ -80,6 +96,7 @@ public:
     bool        set( int year, int month=1, int day=1, int hour=0, int minute=0,
                     int second=0, int millisecond=0 ) ;
     bool        setSystem( void ) ;
+    bool        setSystem( const GlobalPosition &gp ) ;
     bool        setTime( int hour=0, int minute=0, int second=0,
                     int millisecond=0 ) ;
     int         year( void ) const ;
@@ -101,6 +118,7 @@ public:
     bool        astronomicalDusk( const GlobalPosition &gp ) ;
     bool        civilDawn( const GlobalPosition &gp ) ;
     bool        civilDusk( const GlobalPosition &gp ) ;
+    double      dayLength( const GlobalPosition &gp ) const ;
     bool        moonRise( const GlobalPosition &gp ) ;
     bool        moonSet( const GlobalPosition &gp ) ;
     bool        nauticalDawn( const GlobalPosition &gp ) ;
@@ -123,58 +141,81 @@ public:
     bool        winterSolstice( int year, const GlobalPosition &gp ) ;
     bool        winterSolstice( const GlobalPosition &gp ) ;
 
-    bool        checkCalendarDate( void ) { return( calculateCalendarDate() ); }
+    bool        checkCalendarDate( void ) ;
 
 // Private methods
 private:
-    bool        calculateCalendarDate( void ) ;
-    double      calculateJulianDate( void ) ;
-    bool        calculateSolstice( int i, const GlobalPosition &gp ) ;
+    void        calculateCalendarDate( void ) const ;
+    void        calculateFlag( void ) const ;
+    void        calculateJulianDate( void ) const ;
+    bool        calculateSolstice( int event, int year,
+                    const GlobalPosition &gp ) ;
     bool        calculateSunTime( int event, const GlobalPosition &gp ) ;
+    void        calendarDateChanged( void ) ;
+    void        julianDateChanged( void ) ;
+    void        updateCalendarDate( void ) const
+                { if ( m_dirty & CalendarDateDirty ) calculateCalendarDate(); }
+    void        updateFlag( void ) const
+                { if ( m_dirty & FlagDirty ) calculateFlag(); }
+    void        updateJulianDate( void ) const
+                { if ( m_dirty & JulianDateDirty ) calculateJulianDate(); }
 
 //  Protected data members
 protected:
+    /*! \enum DateTimeDirty
+        \brief Bits of #m_dirty identifying the stale DateTime representations.
+    */
+    enum DateTimeDirty
+    {
+        JulianDateDirty   = 1,  /*!< #m_jdate must be recomputed from the fields. */
+        CalendarDateDirty = 2,  /*!< The fields must be recomputed from #m_jdate. */
+        FlagDirty         = 4   /*!< #m_flag must be recomputed by validation. */
+    };
     /*! \var double m_jdate
         \brief Julian date (decimal days since noon of Jan 1, -4712).
     */
-    double  m_jdate;
+    mutable double  m_jdate;
     /*! \var m_year
         \brief Julian-Gregorian calendar year (-4712 or later).
     */
-    int     m_year;
+    mutable int     m_year;
     /*! \var int m_month
         \brief Month of the year (1=Jan, 12=Dec).
     */
-    int     m_month;
+    mutable int     m_month;
     /*! \var int m_day
         \brief Day of the month (1-31).
     */
-    int     m_day;
+    mutable int     m_day;
     /*! \var int m_hour
         \brief Hour of the day, e.g. elapsed hours since midnight (0-23).
     */
-    int     m_hour;
+    mutable int     m_hour;
     /*! \var int m_minute
         \brief Minute of the hour, e.g. elapsed minutes since the hour (0-59).
     */
-    int     m_minute;
+    mutable int     m_minute;
     /*! \var int m_second
         \brief Second of the minute, e.g. elapsed seconds since the minute (0-59).
     */
-    int     m_second;
+    mutable int     m_second;
     /*! \var m_millisecond
         \brief Millisecond of the second (0-999).
     */
-    int     m_millisecond;
+    mutable int     m_millisecond;
     /*! \var int m_event
         \brief #CDT_Event enumeration value of the last DateTime operation.
     */
-    int     m_event;
+    int             m_event;
     /*! \var int m_flag
         \brief #CDT_Flag enumeration value of the result of the last DateTime
         operation.
     */
-    int     m_flag;
+    mutable int     m_flag;
+    /*! \var int m_dirty
+        \brief #DateTimeDirty bits of the representations that are stale.
+    */
+    mutable int     m_dirty;
 };
 
 #endif
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*! \file datetimerange.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fixed-step date-time range C++ source code.
+ *
+ *  The DateTimeRange class steps through a series of equally spaced date-times
+ *  without a calendar conversion per step.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "datetime.h"
+#include "datetimerange.h"
+#include "timestamp.h"
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a DateTimeRange from \a first through \a last, inclusive.
+ *
+ *  \param first Reference to the first DateTime of the range.
+ *  \param last Reference to the last DateTime of the range.  If the steps do
+ *  not land on \a last, the range ends at the last step before it.
+ *  \param stepMilliseconds Step size in milliseconds (1 or more, so up to
+ *  about 24 days).  The range is empty if the step is not positive or if
+ *  \a last precedes \a first.
+ */
+
+DateTimeRange::DateTimeRange( const DateTime &first, const DateTime &last,
+        int stepMilliseconds ) :
+    m_count(0)
+{
+    init( first, stepMilliseconds );
+    TimeStamp ts( last );
+    long long span = ( (long long) ts.dayNumber() - m_firstJdn )
+                   * TimeStamp::MsPerDay
+                   + ( ts.millisecondOfDay() - m_firstMs );
+    if ( stepMilliseconds > 0 && span >= 0 )
+    {
+        m_count = (int) ( span / stepMilliseconds ) + 1;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a DateTimeRange of \a count date-times beginning at
+ *  \a first.
+ *
+ *  \param first Reference to the first DateTime of the range.
+ *  \param count Number of date-times in the range.
+ *  \param stepMilliseconds Step size in milliseconds (1 or more, so up to
+ *  about 24 days).  The range is empty if the step is not positive.
+ */
+
+DateTimeRange::DateTimeRange( const DateTime &first, int count,
+        int stepMilliseconds ) :
+    m_count(0)
+{
+    init( first, stepMilliseconds );
+    if ( stepMilliseconds > 0 && count > 0 )
+    {
+        m_count = count;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts the current #m_jdn Julian day number into the calendar
+ *  date and determines how far #m_day may then be incremented.
+ *
+ *  The last day of the month is normally the limit.  The one month whose
+ *  day numbers are not consecutive (the Gregorian reform, October 1582)
+ *  is converted day by day.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTimeRange::calculateMonth( void )
+{
+    CDT_DayNumberDate( m_jdn, &m_year, &m_month, &m_day );
+    if ( m_year == 1582 && m_month == 10 )
+    {
+        m_monthEnd = m_jdn;
+    }
+    else
+    {
+        m_monthEnd = m_jdn + CDT_DaysInMonth( m_year, m_month ) - m_day;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of date-times in the DateTimeRange.
+ *
+ *  \return Number of date-times in the range.
+ */
+
+int DateTimeRange::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Rewinds the DateTimeRange to its first date-time.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTimeRange::first( void )
+{
+    m_index = 0;
+    m_jdn = m_firstJdn;
+    CDT_MillisecondTime( m_firstMs, &m_hour, &m_minute, &m_second,
+        &m_millisecond );
+    calculateMonth();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores the first date-time and splits the step into its calendar
+ *  components.
+ *
+ *  \param first Reference to the first DateTime of the range.
+ *  \param stepMilliseconds Step size in milliseconds.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTimeRange::init( const DateTime &first, int stepMilliseconds )
+{
+    TimeStamp ts( first );
+    m_firstJdn = ts.dayNumber();
+    m_firstMs  = ts.millisecondOfDay();
+
+    int step = ( stepMilliseconds > 0 ) ? stepMilliseconds : 0;
+    m_stepDays = step / 86400000;
+    CDT_MillisecondTime( step % 86400000, &m_stepHour, &m_stepMinute,
+        &m_stepSecond, &m_stepMillisecond );
+    this->first();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the Julian date of the current DateTimeRange date-time.
+ *
+ *  The sum is formed exactly as by CDT_JulianDate(), so the result is
+ *  identical to that of a DateTime holding the same date and time.
+ *
+ *  \return Julian date in decimal days.
+ */
+
+double DateTimeRange::julianDate( void ) const
+{
+    return( (double) ( m_jdn - 1720995L )
+          + CDT_DecimalDay( m_hour, m_minute, m_second, m_millisecond )
+          + 1720994.5 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores the current DateTimeRange date-time into a DateTime.
+ *
+ *  Only the calendar fields are stored; the DateTime computes its Julian
+ *  date when first asked for it.
+ *
+ *  \param dt Reference to the DateTime to update.
+ *
+ *  \return The function returns nothing.
+ */
+
+void DateTimeRange::toDateTime( DateTime &dt ) const
+{
+    dt.set( m_year, m_month, m_day, m_hour, m_minute, m_second,
+        m_millisecond );
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of datetimerange.cpp
+//------------------------------------------------------------------------------
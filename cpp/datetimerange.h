@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+/*! \file datetimerange.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fixed-step date-time range C++ API header.
+ *
+ *  The DateTimeRange class steps through a series of equally spaced date-times
+ *  without a calendar conversion per step.
+ */
+
+#ifndef _DATETIMERANGE_H_
+/*! \def _DATETIMERANGE_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _DATETIMERANGE_H_ 1
+
+// Forward class references
+class DateTime;
+
+//------------------------------------------------------------------------------
+/*! \class DateTimeRange datetimerange.h
+ *
+ *  \brief Steps from a first date-time through a last date-time by a fixed
+ *  number of milliseconds.
+ *
+ *  Hourly (or any fixed-step) forecast loops that call DateTime::addHours()
+ *  pay for a Julian date to calendar conversion on every step.  A
+ *  DateTimeRange instead splits the step into days, hours, minutes, seconds
+ *  and milliseconds once, and each next() adds those to the current calendar
+ *  fields with carry.  A full CDT_DayNumberDate() conversion is only done
+ *  when the day steps out of the current month.
+ *
+ *  Usage:
+ *  \code
+ *  DateTimeRange range( begin, end, 3600000 );
+ *  for ( range.first(); ! range.done(); range.next() )
+ *  {
+ *      process( range.year(), range.month(), range.day(), range.hour() );
+ *  }
+ *  \endcode
+ *
+ *  \sa DateTime, TimeStamp
+ */
+
+class DateTimeRange
+{
+// Public methods
+public:
+    DateTimeRange( const DateTime &first, const DateTime &last,
+                int stepMilliseconds ) ;
+    DateTimeRange( const DateTime &first, int count, int stepMilliseconds ) ;
+
+    int         count( void ) const ;
+    void        first( void ) ;
+    double      julianDate( void ) const ;
+    void        toDateTime( DateTime &dt ) const ;
+
+    /*! \brief Gets the DateTimeRange day of the month (1-31). */
+    int  day( void ) const { return( m_day ); }
+    /*! \brief Gets the Julian day number of the current civil date. */
+    long dayNumber( void ) const { return( m_jdn ); }
+    /*! \brief Returns TRUE once next() has stepped past the last date-time. */
+    bool done( void ) const { return( m_index >= m_count ); }
+    /*! \brief Gets the DateTimeRange hour of the day (0-23). */
+    int  hour( void ) const { return( m_hour ); }
+    /*! \brief Gets the number of steps taken since first() (0-count()). */
+    int  index( void ) const { return( m_index ); }
+    /*! \brief Gets the DateTimeRange millisecond of the second (0-999). */
+    int  millisecond( void ) const { return( m_millisecond ); }
+    /*! \brief Gets the DateTimeRange minute of the hour (0-59). */
+    int  minute( void ) const { return( m_minute ); }
+    /*! \brief Gets the DateTimeRange month of the year (1-12). */
+    int  month( void ) const { return( m_month ); }
+    /*! \brief Gets the DateTimeRange second of the minute (0-59). */
+    int  second( void ) const { return( m_second ); }
+    /*! \brief Gets the DateTimeRange Julian-Gregorian year. */
+    int  year( void ) const { return( m_year ); }
+
+    /*! \brief Advances the DateTimeRange by one step. */
+    void next( void )
+    {
+        int carry = 0;
+        if ( ( m_millisecond += m_stepMillisecond ) >= 1000 )
+        {
+            m_millisecond -= 1000;
+            carry = 1;
+        }
+        if ( ( m_second += m_stepSecond + carry ) >= 60 )
+        {
+            m_second -= 60;
+            carry = 1;
+        }
+        else
+        {
+            carry = 0;
+        }
+        if ( ( m_minute += m_stepMinute + carry ) >= 60 )
+        {
+            m_minute -= 60;
+            carry = 1;
+        }
+        else
+        {
+            carry = 0;
+        }
+        if ( ( m_hour += m_stepHour + carry ) >= 24 )
+        {
+            m_hour -= 24;
+            carry = 1;
+        }
+        else
+        {
+            carry = 0;
+        }
+        if ( ( carry += m_stepDays ) )
+        {
+            m_jdn += carry;
+            if ( m_jdn > m_monthEnd )
+            {
+                calculateMonth();
+            }
+            else
+            {
+                m_day += carry;
+            }
+        }
+        m_index++;
+    }
+
+// Private methods
+private:
+    void        calculateMonth( void ) ;
+    void        init( const DateTime &first, int stepMilliseconds ) ;
+
+// Protected member data
+protected:
+    /*! \var long m_firstJdn
+        \brief Julian day number of the first date-time.
+    */
+    long    m_firstJdn;
+    /*! \var int m_firstMs
+        \brief Millisecond of the day of the first date-time.
+    */
+    int     m_firstMs;
+    /*! \var int m_count
+        \brief Number of date-times in the range.
+    */
+    int     m_count;
+    /*! \var int m_stepDays
+        \brief Whole days of the step.
+    */
+    int     m_stepDays;
+    /*! \var int m_stepHour
+        \brief Hours of the step remaining after whole days (0-23).
+    */
+    int     m_stepHour;
+    /*! \var int m_stepMinute
+        \brief Minutes of the step remaining after whole hours (0-59).
+    */
+    int     m_stepMinute;
+    /*! \var int m_stepSecond
+        \brief Seconds of the step remaining after whole minutes (0-59).
+    */
+    int     m_stepSecond;
+    /*! \var int m_stepMillisecond
+        \brief Milliseconds of the step remaining after whole seconds (0-999).
+    */
+    int     m_stepMillisecond;
+    /*! \var int m_index
+        \brief Number of steps taken since first().
+    */
+    int     m_index;
+    /*! \var long m_jdn
+        \brief Julian day number of the current civil date.
+    */
+    long    m_jdn;
+    /*! \var long m_monthEnd
+        \brief Julian day number of the last day that may be reached by
+        incrementing #m_day without a full conversion.
+    */
+    long    m_monthEnd;
+    /*! \var int m_year
+        \brief Current Julian-Gregorian year.
+    */
+    int     m_year;
+    /*! \var int m_month
+        \brief Current month of the year (1-12).
+    */
+    int     m_month;
+    /*! \var int m_day
+        \brief Current day of the month (1-31).
+    */
+    int     m_day;
+    /*! \var int m_hour
+        \brief Current hour of the day (0-23).
+    */
+    int     m_hour;
+    /*! \var int m_minute
+        \brief Current minute of the hour (0-59).
+    */
+    int     m_minute;
+    /*! \var int m_second
+        \brief Current second of the minute (0-59).
+    */
+    int     m_second;
+    /*! \var int m_millisecond
+        \brief Current millisecond of the second (0-999).
+    */
+    int     m_millisecond;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of datetimerange.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+/*! \file geoposition.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compact global position C++ source code.
+ *
+ *  The GeoPosition class is a Qt-free, trivially copyable alternative to
+ *  GlobalPosition for large site catalogs.
+ */
+
+// Custom include files
+#include "geoposition.h"
+#include "namepool.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new GeoPosition at the equator and Greenwich Meridian
+ *  with no GMT difference and empty names.
+ */
+
+GeoPosition::GeoPosition( void ) :
+    m_lat(0.),
+    m_lon(0.),
+    m_gmt(0.),
+    m_location(0),
+    m_zone(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new GeoPosition instance with the passed values.
+ *
+ *  \param longitude Longitude in degrees (west of Greenwich is positive).
+ *  \param latitude Latitude in degrees (north of the equator is positive).
+ *  \param gmtDiff Local time difference from GMT in hours.
+ *  \param location NamePool handle of the geographic place name.
+ *  \param zone NamePool handle of the time zone name.
+ */
+
+GeoPosition::GeoPosition( double longitude, double latitude, double gmtDiff,
+        int location, int zone ) :
+    m_lat(latitude),
+    m_lon(longitude),
+    m_gmt(gmtDiff),
+    m_location(location),
+    m_zone(zone)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the local time difference from GMT.
+ *
+ *  \return Local time difference from GMT in hours.
+ */
+
+double GeoPosition::gmtDiff( void ) const
+{
+    return( m_gmt );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the local time difference from GMT.
+ *
+ *  \param hours Local time difference from GMT in hours.
+ *
+ *  \return New local time difference from GMT in hours.
+ */
+
+double GeoPosition::gmtDiff( double hours )
+{
+    return( m_gmt = hours );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the position latitude.
+ *
+ *  \return Position latitude in decimal degrees (north is positive).
+ */
+
+double GeoPosition::latitude( void ) const
+{
+    return( m_lat );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the position latitude.
+ *
+ *  \param degrees New latitude in decimal degrees (north is positive).
+ *
+ *  \return New position latitude in decimal degrees.
+ */
+
+double GeoPosition::latitude( double degrees )
+{
+    return( m_lat = degrees );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the location name handle.
+ *
+ *  \return NamePool handle of the geographic place name.
+ */
+
+int GeoPosition::location( void ) const
+{
+    return( m_location );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the location name handle.
+ *
+ *  \param handle NamePool handle of the geographic place name.
+ *
+ *  \return New location name handle.
+ */
+
+int GeoPosition::location( int handle )
+{
+    return( m_location = handle );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the position longitude.
+ *
+ *  \return Position longitude in decimal degrees (west is positive).
+ */
+
+double GeoPosition::longitude( void ) const
+{
+    return( m_lon );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the position longitude.
+ *
+ *  \param degrees New longitude in decimal degrees (west is positive).
+ *
+ *  \return New position longitude in decimal degrees.
+ */
+
+double GeoPosition::longitude( double degrees )
+{
+    return( m_lon = degrees );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Prints the GeoPosition member data to the FILE stream.
+ *
+ *  \param fptr Pointer to an open FILE stream.
+ *  \param pool Pointer to the NamePool holding the location and zone names,
+ *  or NULL if the names are not to be printed.
+ */
+
+void GeoPosition::print( FILE *fptr, const NamePool *pool ) const
+{
+    if ( pool && ( m_location || m_zone ) )
+    {
+        fprintf( fptr, "%s (%s): ",
+            pool->name( m_location ), pool->name( m_zone ) );
+    }
+    fprintf( fptr,
+        "Global position is %s%3.2f, %s%3.2f (GMT + %1.2f)\n",
+        ( m_lon >= 0. )
+            ? "W"
+            : "E",
+        fabs( m_lon ),
+        ( m_lat >= 0. )
+            ? "N"
+            : "S",
+        fabs( m_lat ),
+        m_gmt );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the longitude, latitude, and GMT difference.
+ *
+ *  \param longitude The new longitude in decimal degrees.
+ *  \param latitude The new latitude in decimal degrees.
+ *  \param gmtDiff The new local time difference from GMT in hours.
+ */
+
+void GeoPosition::setPosition( double longitude, double latitude,
+    double gmtDiff )
+{
+    m_lon = longitude;
+    m_lat = latitude;
+    m_gmt = gmtDiff;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the time zone name handle.
+ *
+ *  \return NamePool handle of the time zone name.
+ */
+
+int GeoPosition::zone( void ) const
+{
+    return( m_zone );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the time zone name handle.
+ *
+ *  \param handle NamePool handle of the time zone name.
+ *
+ *  \return New time zone name handle.
+ */
+
+int GeoPosition::zone( int handle )
+{
+    return( m_zone = handle );
+}
+
+//------------------------------------------------------------------------------
+//  End of geoposition.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*! \file geoposition.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compact global position C++ API header.
+ *
+ *  The GeoPosition class is a Qt-free, trivially copyable alternative to
+ *  GlobalPosition for large site catalogs.
+ */
+
+#ifndef _GEOPOSITION_H_
+/*! \def _GEOPOSITION_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _GEOPOSITION_H_ 1
+
+// Forward class references
+class NamePool;
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \class GeoPosition geoposition.h
+ *
+ *  \brief Defines a position on the globe in 32 bytes.
+ *
+ *  Holds the same longitude, latitude, and GMT difference as a
+ *  GlobalPosition, but the location and time zone names are integer
+ *  handles into a NamePool rather than QStrings.  There are no virtual
+ *  methods and no user-defined copy semantics, so a GeoPosition is
+ *  trivially copyable: arrays of them may be memcpy()'d and handed to other
+ *  threads with no reference counting.
+ *
+ *  Use GlobalPosition( const GeoPosition &, const NamePool & ) and
+ *  GlobalPosition::geoPosition() to convert between the two.
+ */
+
+class GeoPosition
+{
+// Public methods
+public:
+    GeoPosition( void ) ;
+    GeoPosition( double longitude, double latitude, double gmtDiff,
+        int location=0, int zone=0 ) ;
+
+    double   gmtDiff( void ) const ;
+    double   gmtDiff( double hours ) ;
+    double   latitude( void ) const ;
+    double   latitude( double degrees ) ;
+    int      location( void ) const ;
+    int      location( int handle ) ;
+    double   longitude( void ) const ;
+    double   longitude( double degrees ) ;
+    void     print( FILE *fptr, const NamePool *pool=0 ) const ;
+    void     setPosition( double longitude, double latitude, double gmtDiff ) ;
+    int      zone( void ) const ;
+    int      zone( int handle ) ;
+
+// Protected member data
+protected:
+    /*! \var double m_lat
+        \brief Latitude in decimal degrees (north is positive).
+    */
+    double  m_lat;
+    /*! \var double m_lon
+        \brief Longitude in decimal degrees (west is positive).
+    */
+    double  m_lon;
+    /*! \var double m_gmt
+        \brief Local time difference from GMT in hours.
+    */
+    double  m_gmt;
+    /*! \var int m_location
+        \brief NamePool handle of the optional geographic place name.
+    */
+    int     m_location;
+    /*! \var int m_zone
+        \brief NamePool handle of the optional time zone name.
+    */
+    int     m_zone;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of geoposition.h
+//------------------------------------------------------------------------------
@@ -10,7 +10,10 @@
  */
 
 // Custom include files
+#include "geoposition.h"
 #include "globalposition.h"
+#include "namepool.h"
+#include "zonetable.h"
 
 // Qt include files
 #include <qstring.h>
@@ -32,7 +35,9 @@ GlobalPosition::GlobalPosition( void ) :
     m_zoneName(""),
     m_lat(0.),
     m_lon(0.),
-    m_gmt(0.)
+    m_gmt(0.),
+    m_zoneTable(0),
+    m_zone(-1)
 {
     return;
 }
@@ -48,7 +53,9 @@ GlobalPosition::GlobalPosition( GlobalPosition &gp ) :
     m_zoneName(gp.m_zoneName),
     m_lat(gp.m_lat),
     m_lon(gp.m_lon),
-    m_gmt(gp.m_gmt)
+    m_gmt(gp.m_gmt),
+    m_zoneTable(gp.m_zoneTable),
+    m_zone(gp.m_zone)
 {
     return;
 }
@@ -76,7 +83,9 @@ GlobalPosition::GlobalPosition( double longitude, double latitude,
     m_zoneName(""),
     m_lat(latitude),
     m_lon(longitude),
-    m_gmt(gmtDiff)
+    m_gmt(gmtDiff),
+    m_zoneTable(0),
+    m_zone(-1)
 {
     return;
 }
@@ -107,7 +116,29 @@ GlobalPosition::GlobalPosition(
     m_zoneName(zoneName),
     m_lat(latitude),
     m_lon(longitude),
-    m_gmt(gmtDiff)
+    m_gmt(gmtDiff),
+    m_zoneTable(0),
+    m_zone(-1)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new GlobalPosition from a compact GeoPosition.
+ *
+ *  \param geo Reference to an existing GeoPosition.
+ *  \param pool Reference to the NamePool holding the \a geo location and
+ *  zone names.
+ */
+
+GlobalPosition::GlobalPosition( const GeoPosition &geo, const NamePool &pool ) :
+    m_locationName( pool.name( geo.location() ) ),
+    m_zoneName( pool.name( geo.zone() ) ),
+    m_lat( geo.latitude() ),
+    m_lon( geo.longitude() ),
+    m_gmt( geo.gmtDiff() ),
+    m_zoneTable(0),
+    m_zone(-1)
 {
     return;
 }
@@ -121,6 +152,22 @@ GlobalPosition::~GlobalPosition( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Gets a compact, Qt-free copy of the GlobalPosition.
+ *
+ *  \param pool Reference to the NamePool into which the location and zone
+ *  names are interned.
+ *
+ *  \return A GeoPosition with the same coordinates and names.
+ */
+
+GeoPosition GlobalPosition::geoPosition( NamePool &pool ) const
+{
+    return( GeoPosition( m_lon, m_lat, m_gmt,
+        pool.intern( m_locationName.latin1() ),
+        pool.intern( m_zoneName.latin1() ) ) );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Gets the local time difference from GMT.
  *
@@ -145,6 +192,43 @@ double GlobalPosition::gmtDiff( double hours )
     return( m_gmt = hours );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Gets the local time difference from GMT at a local date and time.
+ *
+ *  \param jdate Local Julian date.
+ *
+ *  \return Local time difference from GMT in hours from the linked time
+ *  zone (see ZoneTable::localOffsetAt()), or the fixed gmtDiff() if the
+ *  position is not linked to a zone.
+ */
+
+double GlobalPosition::gmtDiffAt( double jdate ) const
+{
+    if ( m_zone < 0 )
+    {
+        return( m_gmt );
+    }
+    return( m_zoneTable->localOffsetAt( m_zone, jdate ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the local time difference from GMT at a GMT date and time.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return Local time difference from GMT in hours from the linked time
+ *  zone, or the fixed gmtDiff() if the position is not linked to a zone.
+ */
+
+double GlobalPosition::gmtDiffAtGMT( double jdate ) const
+{
+    if ( m_zone < 0 )
+    {
+        return( m_gmt );
+    }
+    return( m_zoneTable->offsetAt( m_zone, jdate ) );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Gets the position latitude.
  *
@@ -288,13 +372,51 @@ const QString &GlobalPosition::zoneName( void ) const
 
 //------------------------------------------------------------------------------
 /*! \brief Sets the current time zone name.
+ *
+ *  If the position is linked to a ZoneTable, it is relinked to the new zone
+ *  (or unlinked if the table does not contain it).
  *
  *  \return Reference to the new zone name.
  */
 
 QString &GlobalPosition::zoneName( const QString &name )
 {
-    return( m_zoneName = name );
+    m_zoneName = name;
+    if ( m_zoneTable )
+    {
+        m_zone = m_zoneTable->zone( m_zoneName.latin1() );
+    }
+    return( m_zoneName );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the time zone rules table linked to the position.
+ *
+ *  \return Pointer to the ZoneTable, or NULL if none.
+ */
+
+const ZoneTable *GlobalPosition::zoneTable( void ) const
+{
+    return( m_zoneTable );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Links the position's zoneName() to a time zone rules table.
+ *
+ *  The table must outlive the GlobalPosition (and any copies of it).
+ *
+ *  \param table Pointer to the ZoneTable, or NULL to unlink the position
+ *  and revert to the fixed gmtDiff().
+ *
+ *  \return TRUE if the table contains the zoneName(), FALSE if not (in which
+ *  case the fixed gmtDiff() continues to be used).
+ */
+
+bool GlobalPosition::zoneTable( const ZoneTable *table )
+{
+    m_zoneTable = table;
+    m_zone = ( table ) ? table->zone( m_zoneName.latin1() ) : -1;
+    return( m_zone >= 0 );
 }
 
 //------------------------------------------------------------------------------
@@ -309,9 +431,13 @@ QString &GlobalPosition::zoneName( const QString &name )
 
 GlobalPosition &GlobalPosition::operator=( const GlobalPosition &gp )
 {
-    m_lon = gp.m_lon;
+    m_locationName = gp.m_locationName;
+    m_zoneName = gp.m_zoneName;
     m_lat = gp.m_lat;
+    m_lon = gp.m_lon;
     m_gmt = gp.m_gmt;
+    m_zoneTable = gp.m_zoneTable;
+    m_zone = gp.m_zone;
     return( *this );
 }
 
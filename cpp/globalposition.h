@@ -18,11 +18,21 @@
 #include <qstring.h>
 #include <stdio.h>
 
+// Forward class references
+class GeoPosition;
+class NamePool;
+class ZoneTable;
+
 //------------------------------------------------------------------------------
 /*! \class GlobalPosition globalposition.h
  *
  *  \brief Defines a position on the globe.
  *  Used along with the DateTime class to get sun/moon times.
+ *
+ *  The local time difference from GMT is normally the fixed #m_gmt.  Once
+ *  zoneTable() links the position to a ZoneTable containing its
+ *  zoneName(), gmtDiffAt() and gmtDiffAtGMT() follow that zone's daylight
+ *  saving and historical offsets instead.
  */
 
 class GlobalPosition
@@ -34,11 +44,15 @@ public:
     GlobalPosition( double longitude, double latitude, double gmtDiff ) ;
     GlobalPosition( const QString &locationName, const QString &zoneName,
         double longitude, double latitude, double gmtDiff ) ;
+    GlobalPosition( const GeoPosition &geo, const NamePool &pool ) ;
     GlobalPosition &operator=( const GlobalPosition &dt ) ;
     virtual ~GlobalPosition( void ) ;
 
+    GeoPosition geoPosition( NamePool &pool ) const ;
     double   gmtDiff( void ) const ;
     double   gmtDiff( double hours ) ;
+    double   gmtDiffAt( double jdate ) const ;
+    double   gmtDiffAtGMT( double jdate ) const ;
     double   latitude( void ) const ;
     double   latitude( double degrees ) ;
     const QString &locationName( void ) const ;
@@ -49,6 +63,8 @@ public:
     void     setPosition( double longitude, double latitude, double gmtDiff ) ;
     const QString &zoneName( void ) const ;
     QString &zoneName( const QString &name ) ;
+    const ZoneTable *zoneTable( void ) const ;
+    bool     zoneTable( const ZoneTable *table ) ;
 
 // Protected member data
 protected:
@@ -89,6 +105,14 @@ protected:
         \arg PDT -7
  */
     double  m_gmt;
+    /*! \var const ZoneTable *m_zoneTable
+        \brief Optional time zone rules table holding #m_zoneName.
+    */
+    const ZoneTable *m_zoneTable;
+    /*! \var int m_zone
+        \brief Handle of #m_zoneName in #m_zoneTable, or -1 if unlinked.
+    */
+    int     m_zone;
 };
 
 //------------------------------------------------------------------------------
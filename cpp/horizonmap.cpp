@@ -0,0 +1,313 @@
+//------------------------------------------------------------------------------
+/*! \file horizonmap.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Topographic horizon map C++ source code.
+ *
+ *  The HorizonMap class precomputes the local horizon of every cell of an
+ *  elevation raster so that cast shadows from surrounding terrain can be
+ *  applied to the Calendar-Date-Time Library solar radiation model.
+ *
+ *  \par References:
+ *
+ *  Dozier, Jeff; Frew, James.  1990.  Rapid calculation of terrain parameters
+ *  for radiation modeling from digital elevation data.  IEEE Transactions on
+ *  Geoscience and Remote Sensing 28(5):963-969.
+ */
+
+// Custom include files
+#include "horizonmap.h"
+
+// Standard include files
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/*! \var static const double Radians
+ *  \brief Global constant defining the radians per degree.
+ */
+static const double Radians = 0.0174532925199433;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new, empty HorizonMap.
+ *
+ *  compute() must be called before the horizon can be queried.
+ *
+ *  \param rows Number of raster rows.
+ *  \param cols Number of raster columns.
+ *  \param sectors Number of azimuth sectors per cell (1-255).  Sector 0 is
+ *  centered on north and the sectors proceed clockwise.
+ */
+
+HorizonMap::HorizonMap( int rows, int cols, int sectors ) :
+    m_rows(rows),
+    m_cols(cols),
+    m_sectors( ( sectors < 1 ) ? 1 : ( ( sectors > 255 ) ? 255 : sectors ) ),
+    m_horizon(0)
+{
+    for ( int q = 0; q < 256; q++ )
+    {
+        m_sinAngle[q] = sin( Radians * 90. * q / 255. );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief HorizonMap destructor.
+ */
+
+HorizonMap::~HorizonMap( void )
+{
+    delete[] m_horizon;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of raster columns.
+ *
+ *  \return Number of raster columns.
+ */
+
+int HorizonMap::cols( void ) const
+{
+    return( m_cols );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Computes the horizon profile of every cell from an elevation grid.
+ *
+ *  For each azimuth sector, the DEM is traversed along parallel lines in the
+ *  sector direction, walking \e away from the horizon.  Each line keeps the
+ *  upper convex hull of the elevation profile already walked, and the
+ *  horizon of each new cell is the tangent from it to that hull (Dozier and
+ *  Frew 1990).  The cost is therefore proportional to the number of cells
+ *  times the number of sectors, independent of the horizon distance.
+ *
+ *  Earth curvature and refraction are ignored.
+ *
+ *  \param elevation Pointer to a row-major grid of elevations (m).
+ *  \param cellSize Width of a square cell (m).
+ *
+ *  \return TRUE if the horizon map was computed,
+ *  FALSE if the raster is empty or the \a cellSize is not positive.
+ */
+
+bool HorizonMap::compute( const double *elevation, double cellSize )
+{
+    if ( m_rows < 1 || m_cols < 1 || cellSize <= 0. )
+    {
+        return( false );
+    }
+    delete[] m_horizon;
+    m_horizon = new unsigned char[ (size_t) m_rows * m_cols * m_sectors ];
+
+    int n = ( m_rows > m_cols ) ? m_rows : m_cols;
+    double *hullPos = new double[ n ];
+    double *hullElev = new double[ n ];
+    for ( int s = 0; s < m_sectors; s++ )
+    {
+        sweep( s, elevation, cellSize, hullPos, hullElev );
+    }
+    delete[] hullPos;
+    delete[] hullElev;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the horizon angle of a cell in the direction of \a azimuth.
+ *
+ *  \param cell Row-major cell index.
+ *  \param azimuth Direction in degrees clockwise from north.
+ *
+ *  \return Horizon elevation angle in degrees [0..90], or 0 if compute() has
+ *  not been called.
+ */
+
+double HorizonMap::horizonAngle( int cell, double azimuth ) const
+{
+    if ( ! m_horizon )
+    {
+        return( 0. );
+    }
+    return( 90. * m_horizon[ (ptrdiff_t) cell * m_sectors + sector( azimuth ) ]
+        / 255. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the sun is above the local horizon of a cell.
+ *
+ *  \param cell Row-major cell index.
+ *  \param altitude Sun altitude in degrees from the horizontal.
+ *  \param azimuth Sun azimuth in degrees clockwise from north.
+ *
+ *  \return TRUE if the sun is above the cell's local horizon.
+ *
+ *  \sa CDT_SunPosition().
+ */
+
+bool HorizonMap::isSunlit( int cell, double altitude, double azimuth ) const
+{
+    return( isSunlit( cell, sector( azimuth ), sin( Radians * altitude ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the sun is above the local horizon of a cell.
+ *
+ *  This form does no trigonometry, and is intended for raster loops where
+ *  the \a sector and \a sinAltitude are shared by many cells.
+ *
+ *  \param cell Row-major cell index.
+ *  \param sector Azimuth sector of the sun as returned by sector().
+ *  \param sinAltitude Sine of the sun altitude.
+ *
+ *  \return TRUE if the sun is above the cell's local horizon.  Always TRUE
+ *  if compute() has not been called and the sun is above the horizontal.
+ */
+
+bool HorizonMap::isSunlit( int cell, int sector, double sinAltitude ) const
+{
+    if ( ! m_horizon )
+    {
+        return( sinAltitude > 0. );
+    }
+    return( sinAltitude
+        > m_sinAngle[ m_horizon[ (ptrdiff_t) cell * m_sectors + sector ] ] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of raster rows.
+ *
+ *  \return Number of raster rows.
+ */
+
+int HorizonMap::rows( void ) const
+{
+    return( m_rows );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the azimuth sector containing \a azimuth.
+ *
+ *  \param azimuth Direction in degrees clockwise from north.
+ *
+ *  \return Sector index [0..sectors()-1].
+ */
+
+int HorizonMap::sector( double azimuth ) const
+{
+    int s = (int) floor( azimuth * m_sectors / 360. + 0.5 ) % m_sectors;
+    return( ( s < 0 ) ? s + m_sectors : s );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the azimuth sector containing a sun vector.
+ *
+ *  \param sun Sun unit vector [east, north, up] from CDT_SunVector() or
+ *  CDT_SunVectorEph().
+ *
+ *  \return Sector index [0..sectors()-1].
+ */
+
+int HorizonMap::sector( const double *sun ) const
+{
+    return( sector( atan2( sun[0], sun[1] ) / Radians ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of azimuth sectors per cell.
+ *
+ *  \return Number of azimuth sectors per cell.
+ */
+
+int HorizonMap::sectors( void ) const
+{
+    return( m_sectors );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Computes the horizon angles of every cell for one azimuth sector.
+ *
+ *  Called only by compute().  Cells are visited along parallel lines that
+ *  advance one cell per step along the dominant (row or column) axis of the
+ *  sector direction; rounding the other axis places every cell on exactly
+ *  one line.
+ *
+ *  \param sector Azimuth sector index.
+ *  \param elevation Pointer to a row-major grid of elevations (m).
+ *  \param cellSize Width of a square cell (m).
+ *  \param hullPos Work array of at least max(rows, cols) positions.
+ *  \param hullElev Work array of at least max(rows, cols) elevations.
+ */
+
+void HorizonMap::sweep( int sector, const double *elevation, double cellSize,
+        double *hullPos, double *hullElev )
+{
+    // Direction toward the horizon in columns (east) and rows (south)
+    double az = Radians * 360. * sector / m_sectors;
+    double dCol = sin( az );
+    double dRow = -cos( az );
+    bool colMajor = ( fabs( dCol ) >= fabs( dRow ) );
+    int nMajor = ( colMajor ) ? m_cols : m_rows;
+    int nMinor = ( colMajor ) ? m_rows : m_cols;
+    double dMajor = ( colMajor ) ? dCol : dRow;
+    double ratio = ( ( colMajor ) ? dRow : dCol ) / dMajor;
+    double step = cellSize * sqrt( 1. + ratio * ratio );
+
+    // Walk away from the horizon, so cells toward it are visited first
+    int first = ( dMajor > 0. ) ? nMajor - 1 : 0;
+    int inc = ( dMajor > 0. ) ? -1 : 1;
+
+    // Each line j visits minor index j + offset(major)
+    int offEnd = (int) floor( ratio * ( nMajor - 1 ) + 0.5 );
+    int jMin = ( offEnd > 0 ) ? -offEnd : 0;
+    int jMax = ( offEnd < 0 ) ? nMinor - 1 - offEnd : nMinor - 1;
+    for ( int j = jMin; j <= jMax; j++ )
+    {
+        int top = -1;
+        int major = first;
+        for ( int k = 0; k < nMajor; k++, major += inc )
+        {
+            int minor = j + (int) floor( ratio * major + 0.5 );
+            if ( minor < 0 || minor >= nMinor )
+            {
+                continue;
+            }
+            int cell = ( colMajor )
+                     ? minor * m_cols + major
+                     : major * m_cols + minor;
+            double pos = k * step;
+            double z = elevation[cell];
+
+            // Drop hull points hidden behind the next farther hull point
+            while ( top > 0
+                && ( hullElev[top] - z ) / ( pos - hullPos[top] )
+                <= ( hullElev[top-1] - z ) / ( pos - hullPos[top-1] ) )
+            {
+                top--;
+            }
+            // The horizon is the tangent to the remaining hull
+            int q = 0;
+            if ( top >= 0 && hullElev[top] > z )
+            {
+                double angle = atan( ( hullElev[top] - z )
+                             / ( pos - hullPos[top] ) ) / Radians;
+                q = (int) ( angle * 255. / 90. + 0.5 );
+                q = ( q > 255 ) ? 255 : q;
+            }
+            m_horizon[ (ptrdiff_t) cell * m_sectors + sector ] =
+                (unsigned char) q;
+
+            // Add this cell to the hull
+            top++;
+            hullPos[top] = pos;
+            hullElev[top] = z;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of horizonmap.cpp
+//------------------------------------------------------------------------------
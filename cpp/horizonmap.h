@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*! \file horizonmap.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Topographic horizon map C++ API header.
+ *
+ *  The HorizonMap class precomputes the local horizon of every cell of an
+ *  elevation raster so that cast shadows from surrounding terrain can be
+ *  applied to the Calendar-Date-Time Library solar radiation model.
+ */
+
+#ifndef _HORIZONMAP_H_
+/*! \def _HORIZONMAP_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _HORIZONMAP_H_ 1
+
+//------------------------------------------------------------------------------
+/*! \class HorizonMap horizonmap.h
+ *
+ *  \brief Stores the elevation angle of the local horizon of every cell of a
+ *  digital elevation model (DEM) in each of a number of azimuth sectors.
+ *
+ *  CDT_SolarRadiation() only accounts for slope self-shading.  A HorizonMap
+ *  is computed offline, once per DEM, by compute(), after which "is the sun
+ *  above the local horizon" is a constant-time table lookup.
+ *
+ *  Each horizon angle is stored in one byte in units of 90/255 degrees
+ *  (about 0.35 degrees), so a 16-sector profile costs 16 bytes per cell.
+ *  The profile of each cell is contiguous.  Horizons below the horizontal
+ *  plane are stored as zero.
+ *
+ *  The raster is stored in row-major order (row 0 is the northern edge and
+ *  column 0 is the western edge), matching SolarRaster.
+ *
+ *  \sa SolarRaster::setHorizon().
+ */
+
+class HorizonMap
+{
+// Public methods
+public:
+    HorizonMap( int rows, int cols, int sectors=16 ) ;
+    ~HorizonMap( void ) ;
+
+    int      cols( void ) const ;
+    bool     compute( const double *elevation, double cellSize ) ;
+    double   horizonAngle( int cell, double azimuth ) const ;
+    bool     isSunlit( int cell, double altitude, double azimuth ) const ;
+    bool     isSunlit( int cell, int sector, double sinAltitude ) const ;
+    int      rows( void ) const ;
+    int      sector( double azimuth ) const ;
+    int      sector( const double *sun ) const ;
+    int      sectors( void ) const ;
+
+// Private methods
+private:
+    HorizonMap( const HorizonMap &hm ) ;
+    HorizonMap &operator=( const HorizonMap &hm ) ;
+    void     sweep( int sector, const double *elevation, double cellSize,
+                double *hullPos, double *hullElev ) ;
+
+// Protected member data
+protected:
+    /*! \var int m_rows
+        \brief Number of raster rows.
+    */
+    int     m_rows;
+    /*! \var int m_cols
+        \brief Number of raster columns.
+    */
+    int     m_cols;
+    /*! \var int m_sectors
+        \brief Number of azimuth sectors in each cell's horizon profile.
+    */
+    int     m_sectors;
+    /*! \var unsigned char *m_horizon
+        \brief Quantized horizon angles, #m_sectors per cell, or NULL if
+        compute() has not been called.
+    */
+    unsigned char *m_horizon;
+    /*! \var double m_sinAngle[256]
+        \brief Sine of the horizon angle for each quantized value.
+    */
+    double  m_sinAngle[256];
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of horizonmap.h
+//------------------------------------------------------------------------------
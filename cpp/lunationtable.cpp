@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+/*! \file lunationtable.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Precomputed lunation table C++ source code.
+ *
+ *  The LunationTable class caches the Calendar-Date-Time Library new moon
+ *  computations in cdtlib.c for a range of years.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "lunationtable.h"
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new LunationTable covering every new moon period of
+ *  the years \a firstYear through \a lastYear.
+ *
+ *  Includes the last new moon before \a firstYear (period 0) and enough
+ *  lunations after \a lastYear that every period's following full moon is
+ *  also in the table.
+ *
+ *  \param firstYear First Julian-Gregorian calendar year (-4712 or later).
+ *  \param lastYear Last Julian-Gregorian calendar year.
+ */
+
+LunationTable::LunationTable( int firstYear, int lastYear ) :
+    m_first(0),
+    m_count(0),
+    m_newMoon(0)
+{
+    if ( lastYear < firstYear )
+    {
+        lastYear = firstYear;
+    }
+    // A year has at most 14 new moon periods (0-13), plus one to bracket
+    // the last period's full moon
+    m_first = CDT_LunationNumber( firstYear, 0 );
+    int last = CDT_LunationNumber( lastYear, 14 );
+    m_count = last - m_first + 1;
+    m_newMoon = new double[ m_count ];
+    for ( int i = 0; i < m_count; i++ )
+    {
+        m_newMoon[i] = CDT_LunationGMT( m_first + i );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief LunationTable destructor.
+ */
+
+LunationTable::~LunationTable( void )
+{
+    delete[] m_newMoon;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the age of the moon at \a jdate.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return Days since the preceding new moon, or -1 if \a jdate is outside
+ *  the table.
+ */
+
+double LunationTable::age( double jdate ) const
+{
+    int i = lunation( jdate ) - m_first;
+    if ( i < 0 || i >= m_count - 1 )
+    {
+        return( -1. );
+    }
+    return( jdate - m_newMoon[i] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of lunations in the table.
+ *
+ *  \return Number of lunations in the table.
+ */
+
+int LunationTable::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the GMT time of the full moon following the \a period
+ *  \eth new moon of the \a year.
+ *
+ *  \param year Julian-Gregorian calendar year.
+ *  \param period New moon of the \a year (1 == first new moon).
+ *
+ *  \return The Julian date (GMT) of the full moon.
+ *
+ *  \sa DateTime::fullMoon().
+ */
+
+double LunationTable::fullMoonGMT( int year, int period ) const
+{
+    int k = CDT_LunationNumber( year, period );
+    return( 0.5 * ( lunationGMT( k ) + lunationGMT( k + 1 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the lunation in progress at \a jdate.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return Lunation number of the latest new moon at or before \a jdate.
+ *  If \a jdate is outside the table, the returned lunation is also outside
+ *  the table (one before the first or the last entry).
+ */
+
+int LunationTable::lunation( double jdate ) const
+{
+    // Binary search for the last new moon <= jdate
+    int lo = 0;
+    int hi = m_count;
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+        if ( m_newMoon[mid] <= jdate )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return( m_first + lo - 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the GMT time of the new moon of the \a lunation.
+ *
+ *  \param lunation Lunation number as returned by CDT_LunationNumber().
+ *
+ *  \return The Julian date (GMT) of the \a lunation's new moon, from the
+ *  table if possible, otherwise from CDT_LunationGMT().
+ */
+
+double LunationTable::lunationGMT( int lunation ) const
+{
+    int i = lunation - m_first;
+    if ( i < 0 || i >= m_count )
+    {
+        return( CDT_LunationGMT( lunation ) );
+    }
+    return( m_newMoon[i] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the GMT time of the \a period \eth new moon for the \a
+ *  year.
+ *
+ *  Identical to CDT_NewMoonGMT(), but a table lookup within the table's
+ *  years.
+ *
+ *  \param year Julian-Gregorian calendar year.
+ *  \param period New moon of the \a year (1 == first new moon).
+ *
+ *  \return The Julian date (GMT) of the \a period's new moon for the \a year.
+ */
+
+double LunationTable::newMoonGMT( int year, int period ) const
+{
+    return( lunationGMT( CDT_LunationNumber( year, period ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the next full moon after \a jdate.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return The Julian date (GMT) of the first full moon after \a jdate,
+ *  or 0 if it is outside the table.
+ */
+
+double LunationTable::nextFullMoon( double jdate ) const
+{
+    int i = lunation( jdate ) - m_first;
+    if ( i < 0 || i >= m_count - 1 )
+    {
+        return( 0. );
+    }
+    double full = 0.5 * ( m_newMoon[i] + m_newMoon[i+1] );
+    if ( full > jdate )
+    {
+        return( full );
+    }
+    if ( i + 2 >= m_count )
+    {
+        return( 0. );
+    }
+    return( 0.5 * ( m_newMoon[i+1] + m_newMoon[i+2] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the next new moon after \a jdate.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return The Julian date (GMT) of the first new moon after \a jdate,
+ *  or 0 if it is outside the table.
+ */
+
+double LunationTable::nextNewMoon( double jdate ) const
+{
+    int i = lunation( jdate ) - m_first + 1;
+    if ( i < 0 || i >= m_count )
+    {
+        return( 0. );
+    }
+    return( m_newMoon[i] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the phase of the moon at \a jdate.
+ *
+ *  \param jdate GMT Julian date.
+ *
+ *  \return Elapsed fraction of the current lunation [0..1), where 0 is new
+ *  moon and 0.5 is full moon, or -1 if \a jdate is outside the table.
+ */
+
+double LunationTable::phase( double jdate ) const
+{
+    int i = lunation( jdate ) - m_first;
+    if ( i < 0 || i >= m_count - 1 )
+    {
+        return( -1. );
+    }
+    return( ( jdate - m_newMoon[i] ) / ( m_newMoon[i+1] - m_newMoon[i] ) );
+}
+
+//------------------------------------------------------------------------------
+//  End of lunationtable.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+/*! \file lunationtable.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Precomputed lunation table C++ API header.
+ *
+ *  The LunationTable class caches the Calendar-Date-Time Library new moon
+ *  computations in cdtlib.c for a range of years.
+ */
+
+#ifndef _LUNATIONTABLE_H_
+/*! \def _LUNATIONTABLE_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _LUNATIONTABLE_H_ 1
+
+//------------------------------------------------------------------------------
+/*! \class LunationTable lunationtable.h
+ *
+ *  \brief Table of new and full moon times for a range of years.
+ *
+ *  CDT_NewMoonGMT() iterates the lunar perturbation series on every call.
+ *  A LunationTable evaluates it once per lunation when constructed, after
+ *  which new and full moons by year and period are O(1) lookups, and the
+ *  phase, age, and next new or full moon at any time are binary searches.
+ *
+ *  Full moons are defined as in DateTime::fullMoon(), as the midpoint
+ *  between consecutive new moons.  All Julian dates are GMT.
+ *
+ *  \sa CDT_LunationGMT(), CDT_LunationNumber().
+ */
+
+class LunationTable
+{
+// Public methods
+public:
+    LunationTable( int firstYear, int lastYear ) ;
+    ~LunationTable( void ) ;
+
+    double   age( double jdate ) const ;
+    int      count( void ) const ;
+    double   fullMoonGMT( int year, int period ) const ;
+    int      lunation( double jdate ) const ;
+    double   lunationGMT( int lunation ) const ;
+    double   newMoonGMT( int year, int period ) const ;
+    double   nextFullMoon( double jdate ) const ;
+    double   nextNewMoon( double jdate ) const ;
+    double   phase( double jdate ) const ;
+
+// Private methods
+private:
+    LunationTable( const LunationTable &lt ) ;
+    LunationTable &operator=( const LunationTable &lt ) ;
+
+// Protected member data
+protected:
+    /*! \var int m_first
+        \brief Lunation number of the first table entry.
+    */
+    int     m_first;
+    /*! \var int m_count
+        \brief Number of table entries.
+    */
+    int     m_count;
+    /*! \var double *m_newMoon
+        \brief Ascending GMT Julian dates of the new moon of each lunation.
+    */
+    double *m_newMoon;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of lunationtable.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+/*! \file namepool.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Interned name pool C++ source code.
+ */
+
+// Custom include files
+#include "namepool.h"
+
+// Standard include files
+#include <string.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new NamePool containing only the empty name.
+ */
+
+NamePool::NamePool( void ) :
+    m_text(0),
+    m_textSize(0),
+    m_textCapacity(256),
+    m_offset(0),
+    m_count(0),
+    m_capacity(16),
+    m_slot(0),
+    m_slots(0)
+{
+    m_text = new char[ m_textCapacity ];
+    m_offset = new int[ m_capacity ];
+    rehash( 32 );
+    intern( "" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief NamePool destructor.
+ */
+
+NamePool::~NamePool( void )
+{
+    delete[] m_text;
+    delete[] m_offset;
+    delete[] m_slot;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of names in the pool.
+ *
+ *  \return Number of names in the pool, including the empty name.
+ */
+
+int NamePool::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds a name in the pool without adding it.
+ *
+ *  \param name Null-terminated name (NULL is the empty name).
+ *
+ *  \return Handle of the \a name, or -1 if it is not in the pool.
+ */
+
+int NamePool::find( const char *name ) const
+{
+    if ( ! name )
+    {
+        name = "";
+    }
+    return( m_slot[ slot( name, hash( name ) ) ] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief FNV-1a hash of a null-terminated name.
+ *
+ *  \param name Null-terminated name.
+ *
+ *  \return Hash of the \a name.
+ */
+
+unsigned NamePool::hash( const char *name )
+{
+    unsigned h = 2166136261u;
+    while ( *name )
+    {
+        h = ( h ^ (unsigned char) *name++ ) * 16777619u;
+    }
+    return( h );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds a name to the pool if it is not already there.
+ *
+ *  \param name Null-terminated name (NULL is the empty name).
+ *
+ *  \return Handle of the \a name.
+ */
+
+int NamePool::intern( const char *name )
+{
+    if ( ! name )
+    {
+        name = "";
+    }
+    unsigned h = hash( name );
+    int s = slot( name, h );
+    if ( m_slot[s] >= 0 )
+    {
+        return( m_slot[s] );
+    }
+
+    // Append the name text
+    int len = (int) strlen( name ) + 1;
+    if ( m_textSize + len > m_textCapacity )
+    {
+        int capacity = 2 * m_textCapacity;
+        while ( m_textSize + len > capacity )
+        {
+            capacity *= 2;
+        }
+        char *text = new char[ capacity ];
+        memcpy( text, m_text, m_textSize );
+        delete[] m_text;
+        m_text = text;
+        m_textCapacity = capacity;
+    }
+    memcpy( m_text + m_textSize, name, len );
+
+    // Append its offset
+    if ( m_count == m_capacity )
+    {
+        int *offset = new int[ 2 * m_capacity ];
+        memcpy( offset, m_offset, m_count * sizeof(int) );
+        delete[] m_offset;
+        m_offset = offset;
+        m_capacity *= 2;
+    }
+    m_offset[ m_count ] = m_textSize;
+    m_textSize += len;
+    m_slot[s] = m_count;
+
+    // Keep the hash table at most half full
+    if ( 2 * ++m_count > m_slots )
+    {
+        rehash( 2 * m_slots );
+    }
+    return( m_count - 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the name of a handle.
+ *
+ *  \param handle Handle returned by intern() or find().
+ *
+ *  \return Pointer to the null-terminated name, or to the empty name if
+ *  \a handle is not in the pool.
+ */
+
+const char *NamePool::name( int handle ) const
+{
+    if ( handle < 0 || handle >= m_count )
+    {
+        handle = 0;
+    }
+    return( m_text + m_offset[ handle ] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Rebuilds the hash table with \a slots entries.
+ *
+ *  \param slots New number of hash table entries (a power of 2).
+ */
+
+void NamePool::rehash( int slots )
+{
+    delete[] m_slot;
+    m_slot = new int[ slots ];
+    m_slots = slots;
+    for ( int s = 0; s < m_slots; s++ )
+    {
+        m_slot[s] = -1;
+    }
+    for ( int i = 0; i < m_count; i++ )
+    {
+        const char *str = m_text + m_offset[i];
+        m_slot[ slot( str, hash( str ) ) ] = i;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the hash table slot of a name by linear probing.
+ *
+ *  \param name Null-terminated name.
+ *  \param h Hash of the \a name.
+ *
+ *  \return Index of the slot holding the \a name's handle, or of the empty
+ *  slot where it belongs.
+ */
+
+int NamePool::slot( const char *name, unsigned h ) const
+{
+    int mask = m_slots - 1;
+    int s = (int) ( h & mask );
+    while ( m_slot[s] >= 0
+        && strcmp( m_text + m_offset[ m_slot[s] ], name ) != 0 )
+    {
+        s = ( s + 1 ) & mask;
+    }
+    return( s );
+}
+
+//------------------------------------------------------------------------------
+//  End of namepool.cpp
+//------------------------------------------------------------------------------
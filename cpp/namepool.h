@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/*! \file namepool.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Interned name pool C++ API header.
+ */
+
+#ifndef _NAMEPOOL_H_
+/*! \def _NAMEPOOL_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _NAMEPOOL_H_ 1
+
+//------------------------------------------------------------------------------
+/*! \class NamePool namepool.h
+ *
+ *  \brief Pool of unique, immutable names addressed by integer handles.
+ *
+ *  Each distinct name is stored once, and every GeoPosition that refers to
+ *  it holds only its integer handle.  Handle 0 is always the empty name.
+ *  Names are never removed, so a handle remains valid for the life of the
+ *  pool.
+ *
+ *  Interning a name may reallocate the pool's storage, so the pointers
+ *  returned by name() are only valid until the next intern(), and the pool
+ *  must not be modified while other threads are reading it.
+ */
+
+class NamePool
+{
+// Public methods
+public:
+    NamePool( void ) ;
+    ~NamePool( void ) ;
+
+    int         count( void ) const ;
+    int         find( const char *name ) const ;
+    int         intern( const char *name ) ;
+    const char *name( int handle ) const ;
+
+// Private methods
+private:
+    NamePool( const NamePool &np ) ;
+    NamePool &operator=( const NamePool &np ) ;
+    static unsigned hash( const char *name ) ;
+    void        rehash( int slots ) ;
+    int         slot( const char *name, unsigned h ) const ;
+
+// Protected member data
+protected:
+    /*! \var char *m_text
+        \brief Null-terminated names stored end to end.
+    */
+    char   *m_text;
+    /*! \var int m_textSize
+        \brief Number of bytes used in #m_text.
+    */
+    int     m_textSize;
+    /*! \var int m_textCapacity
+        \brief Number of bytes allocated to #m_text.
+    */
+    int     m_textCapacity;
+    /*! \var int *m_offset
+        \brief Offset into #m_text of each name, indexed by handle.
+    */
+    int    *m_offset;
+    /*! \var int m_count
+        \brief Number of names (and handles) in the pool.
+    */
+    int     m_count;
+    /*! \var int m_capacity
+        \brief Number of handles allocated to #m_offset.
+    */
+    int     m_capacity;
+    /*! \var int *m_slot
+        \brief Open-addressed hash table of handles, or -1 if empty.
+    */
+    int    *m_slot;
+    /*! \var int m_slots
+        \brief Number of #m_slot entries (a power of 2).
+    */
+    int     m_slots;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of namepool.h
+//------------------------------------------------------------------------------
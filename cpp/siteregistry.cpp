@@ -0,0 +1,683 @@
+//------------------------------------------------------------------------------
+/*! \file siteregistry.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Site registry C++ source code.
+ *
+ *  The SiteRegistry class stores many GeoPositions in a form suited to the
+ *  Calendar-Date-Time Library batch routines in cdtlib.c.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "siteregistry.h"
+
+// Standard include files
+#include <math.h>
+#include <string.h>
+
+static const double Radians = 0.0174532925199433;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new, empty SiteRegistry.
+ *
+ *  \param capacity Number of sites to allocate space for up front.
+ */
+
+SiteRegistry::SiteRegistry( int capacity ) :
+    m_count(0),
+    m_capacity(0),
+    m_lon(0),
+    m_lat(0),
+    m_gmt(0),
+    m_lonHours(0),
+    m_sinLat(0),
+    m_cosLat(0),
+    m_location(0),
+    m_zone(0),
+    m_tree(0),
+    m_indexed(false)
+{
+    reserve( ( capacity > 16 ) ? capacity : 16 );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief SiteRegistry destructor.
+ */
+
+SiteRegistry::~SiteRegistry( void )
+{
+    delete[] m_lon;
+    delete[] m_lat;
+    delete[] m_gmt;
+    delete[] m_lonHours;
+    delete[] m_sinLat;
+    delete[] m_cosLat;
+    delete[] m_location;
+    delete[] m_zone;
+    delete[] m_tree;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds a site to the registry.
+ *
+ *  \param site Reference to the site's GeoPosition.
+ *
+ *  \return Index of the new site.
+ */
+
+int SiteRegistry::add( const GeoPosition &site )
+{
+    int i = add( site.longitude(), site.latitude(), site.gmtDiff() );
+    m_location[i] = site.location();
+    m_zone[i] = site.zone();
+    return( i );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds an unnamed site to the registry.
+ *
+ *  \param longitude Longitude in degrees (west of Greenwich is positive).
+ *  \param latitude Latitude in degrees (north of the equator is positive).
+ *  \param gmtDiff Local time difference from GMT in hours.
+ *
+ *  \return Index of the new site.
+ */
+
+int SiteRegistry::add( double longitude, double latitude, double gmtDiff )
+{
+    if ( m_count == m_capacity )
+    {
+        reserve( 2 * m_capacity );
+    }
+    int i = m_count++;
+    m_lon[i]      = longitude;
+    m_lat[i]      = latitude;
+    m_gmt[i]      = gmtDiff;
+    m_lonHours[i] = longitude / 15.0;
+    m_sinLat[i]   = sin( Radians * latitude );
+    m_cosLat[i]   = cos( Radians * latitude );
+    m_location[i] = 0;
+    m_zone[i]     = 0;
+    m_tree[i]     = i;
+    m_indexed = false;
+    return( i );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Builds the spatial index used by nearest() and within().
+ */
+
+void SiteRegistry::buildIndex( void )
+{
+    for ( int i = 0; i < m_count; i++ )
+    {
+        m_tree[i] = i;
+    }
+    partition( 0, m_count, 0 );
+    m_indexed = true;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Removes all the sites from the registry.
+ */
+
+void SiteRegistry::clear( void )
+{
+    m_count = 0;
+    m_indexed = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the cosines of the site latitudes.
+ *
+ *  \return Pointer to the array of count() latitude cosines.
+ */
+
+const double *SiteRegistry::cosLatitudes( void ) const
+{
+    return( m_cosLat );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of sites in the registry.
+ *
+ *  \return Number of sites in the registry.
+ */
+
+int SiteRegistry::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a site's local time difference from GMT.
+ *
+ *  \param site Site index.
+ *
+ *  \return Local time difference from GMT in hours.
+ */
+
+double SiteRegistry::gmtDiff( int site ) const
+{
+    return( m_gmt[site] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the spatial index is current.
+ *
+ *  \return TRUE if buildIndex() has been called since the last add().
+ */
+
+bool SiteRegistry::indexed( void ) const
+{
+    return( m_indexed );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a site's coordinate on one of the 2-d tree axes.
+ *
+ *  \param site Site index.
+ *  \param axis 0 for longitude, 1 for latitude.
+ *
+ *  \return The site's longitude or latitude in degrees.
+ */
+
+double SiteRegistry::key( int site, int axis ) const
+{
+    return( axis ? m_lat[site] : m_lon[site] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a site's latitude.
+ *
+ *  \param site Site index.
+ *
+ *  \return Latitude in degrees (north is positive).
+ */
+
+double SiteRegistry::latitude( int site ) const
+{
+    return( m_lat[site] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the site latitudes.
+ *
+ *  \return Pointer to the array of count() latitudes in degrees.
+ */
+
+const double *SiteRegistry::latitudes( void ) const
+{
+    return( m_lat );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a site's longitude.
+ *
+ *  \param site Site index.
+ *
+ *  \return Longitude in degrees (west is positive).
+ */
+
+double SiteRegistry::longitude( int site ) const
+{
+    return( m_lon[site] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the site longitudes in sidereal hours.
+ *
+ *  \return Pointer to the array of count() longitudes divided by 15.
+ */
+
+const double *SiteRegistry::longitudeHours( void ) const
+{
+    return( m_lonHours );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the site longitudes.
+ *
+ *  \return Pointer to the array of count() longitudes in degrees.
+ */
+
+const double *SiteRegistry::longitudes( void ) const
+{
+    return( m_lon );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the position of the moon at every site.
+ *
+ *  \param eph Pointer to a lunar ephemeris from CDT_MoonEphemerisInit().
+ *  \param altitude Returned array of count() moon altitudes in degrees.
+ *  \param azimuth Returned array of count() moon azimuths in degrees
+ *  clockwise from north, or NULL if not wanted.
+ *
+ *  \sa CDT_MoonPositionEph().
+ */
+
+void SiteRegistry::moonPosition( const struct CDT_MoonEphemeris *eph,
+        double *altitude, double *azimuth ) const
+{
+    CDT_SkyPositionArray( eph->gmst, eph->ra, eph->sinDec, eph->cosDec,
+        m_count, m_lonHours, m_sinLat, m_cosLat, altitude, azimuth );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the site nearest a position on the globe.
+ *
+ *  Distances are great circle (haversine) distances, and longitudes wrap
+ *  at the antimeridian.
+ *
+ *  \param longitude Longitude in degrees (west of Greenwich is positive).
+ *  \param latitude Latitude in degrees (north of the equator is positive).
+ *  \param distance If not NULL, returns the great circle distance to the
+ *  nearest site in degrees of arc.
+ *
+ *  \return Index of the nearest site, or -1 if the registry is empty.
+ */
+
+int SiteRegistry::nearest( double longitude, double latitude,
+        double *distance ) const
+{
+    int best = -1;
+    double bestHav = 2.;
+    double cosLat = cos( Radians * latitude );
+    if ( m_indexed )
+    {
+        searchNearest( 0, m_count, 0, -HUGE_VAL, HUGE_VAL, -HUGE_VAL,
+            HUGE_VAL, longitude, latitude, cosLat, &best, &bestHav );
+    }
+    else
+    {
+        for ( int i = 0; i < m_count; i++ )
+        {
+            double sp = sin( 0.5 * Radians * ( m_lat[i] - latitude ) );
+            double sl = sin( 0.5 * Radians * ( m_lon[i] - longitude ) );
+            double hav = sp * sp + cosLat * m_cosLat[i] * sl * sl;
+            if ( hav < bestHav )
+            {
+                bestHav = hav;
+                best = i;
+            }
+        }
+    }
+    if ( distance )
+    {
+        *distance = ( best < 0 ) ? 0.
+                  : 2. * asin( sqrt( ( bestHav < 1. ) ? bestHav : 1. ) )
+                    / Radians;
+    }
+    return( best );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Arranges the sites in m_tree[lo..hi) into a 2-d subtree.
+ *
+ *  Selects the median on the depth's axis into the middle of the range,
+ *  with the smaller keys before it and the larger keys after it, then
+ *  recurses on each half.
+ *
+ *  \param lo Index of the first site in the range.
+ *  \param hi Index beyond the last site in the range.
+ *  \param depth Tree depth of the range's node.
+ */
+
+void SiteRegistry::partition( int lo, int hi, int depth )
+{
+    if ( hi - lo < 2 )
+    {
+        return;
+    }
+    int axis = depth % 2;
+    int m = ( lo + hi ) / 2;
+    int l = lo;
+    int r = hi - 1;
+    while ( l < r )
+    {
+        double pivot = key( m_tree[ ( l + r ) / 2 ], axis );
+        int i = l;
+        int j = r;
+        while ( i <= j )
+        {
+            while ( key( m_tree[i], axis ) < pivot )
+            {
+                i++;
+            }
+            while ( key( m_tree[j], axis ) > pivot )
+            {
+                j--;
+            }
+            if ( i <= j )
+            {
+                int tmp = m_tree[i];
+                m_tree[i++] = m_tree[j];
+                m_tree[j--] = tmp;
+            }
+        }
+        if ( m <= j )
+        {
+            r = j;
+        }
+        else if ( m >= i )
+        {
+            l = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+    partition( lo, m, depth + 1 );
+    partition( m + 1, hi, depth + 1 );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a copy of a site's GeoPosition.
+ *
+ *  \param site Site index.
+ *
+ *  \return The site's GeoPosition.
+ */
+
+GeoPosition SiteRegistry::position( int site ) const
+{
+    return( GeoPosition( m_lon[site], m_lat[site], m_gmt[site],
+        m_location[site], m_zone[site] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Grows the site arrays to hold at least \a capacity sites.
+ *
+ *  \param capacity Number of sites.
+ */
+
+void SiteRegistry::reserve( int capacity )
+{
+    if ( capacity <= m_capacity )
+    {
+        return;
+    }
+    double **darray[6] =
+        { &m_lon, &m_lat, &m_gmt, &m_lonHours, &m_sinLat, &m_cosLat };
+    for ( int a = 0; a < 6; a++ )
+    {
+        double *d = new double[ capacity ];
+        if ( m_count )
+        {
+            memcpy( d, *darray[a], m_count * sizeof(double) );
+        }
+        delete[] *darray[a];
+        *darray[a] = d;
+    }
+    int **iarray[3] = { &m_location, &m_zone, &m_tree };
+    for ( int a = 0; a < 3; a++ )
+    {
+        int *d = new int[ capacity ];
+        if ( m_count )
+        {
+            memcpy( d, *iarray[a], m_count * sizeof(int) );
+        }
+        delete[] *iarray[a];
+        *iarray[a] = d;
+    }
+    m_capacity = capacity;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Recursively collects the sites of a subtree that lie within a
+ *  longitude-latitude box.
+ *
+ *  \param lo Index of the first site in the subtree.
+ *  \param hi Index beyond the last site in the subtree.
+ *  \param depth Tree depth of the subtree's node.
+ *  \param lonMin Western box edge in degrees (west is positive).
+ *  \param latMin Southern box edge in degrees.
+ *  \param lonMax Eastern box edge in degrees.
+ *  \param latMax Northern box edge in degrees.
+ *  \param sites Array to receive the site indices.
+ *  \param maxSites Size of the \a sites array.
+ *  \param found Number of sites found so far; updated on return.
+ */
+
+void SiteRegistry::searchBox( int lo, int hi, int depth, double lonMin,
+        double latMin, double lonMax, double latMax, int *sites,
+        int maxSites, int *found ) const
+{
+    if ( lo >= hi )
+    {
+        return;
+    }
+    int m = ( lo + hi ) / 2;
+    int s = m_tree[m];
+    bool wrap = ( lonMin > lonMax );
+    double lon = m_lon[s];
+    double lat = m_lat[s];
+    if ( lat >= latMin && lat <= latMax
+      && ( wrap ? ( lon >= lonMin || lon <= lonMax )
+                : ( lon >= lonMin && lon <= lonMax ) ) )
+    {
+        if ( *found < maxSites )
+        {
+            sites[ *found ] = s;
+        }
+        ( *found )++;
+    }
+    int axis = depth % 2;
+    double split = key( s, axis );
+    double kMin = axis ? latMin : lonMin;
+    double kMax = axis ? latMax : lonMax;
+    bool both = ( axis == 0 && wrap );
+    if ( both || kMin <= split )
+    {
+        searchBox( lo, m, depth + 1, lonMin, latMin, lonMax, latMax,
+            sites, maxSites, found );
+    }
+    if ( both || kMax >= split )
+    {
+        searchBox( m + 1, hi, depth + 1, lonMin, latMin, lonMax, latMax,
+            sites, maxSites, found );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Recursively searches a subtree for a site nearer than the best
+ *  found so far.
+ *
+ *  The subtree is skipped if the haversine of the shortest distance from
+ *  the query position to the subtree's bounding box cannot beat the best.
+ *  The latitude bound is the latitude difference, and the longitude bound
+ *  is the distance to the nearest bounding meridian.
+ *
+ *  \param lo Index of the first site in the subtree.
+ *  \param hi Index beyond the last site in the subtree.
+ *  \param depth Tree depth of the subtree's node.
+ *  \param lonLo Western bound of the subtree's longitudes.
+ *  \param lonHi Eastern bound of the subtree's longitudes.
+ *  \param latLo Southern bound of the subtree's latitudes.
+ *  \param latHi Northern bound of the subtree's latitudes.
+ *  \param lon Query longitude in degrees.
+ *  \param lat Query latitude in degrees.
+ *  \param cosLat Cosine of the query latitude.
+ *  \param best Index of the nearest site so far; updated on return.
+ *  \param bestHav Haversine of the distance to the nearest site so far;
+ *  updated on return.
+ */
+
+void SiteRegistry::searchNearest( int lo, int hi, int depth, double lonLo,
+        double lonHi, double latLo, double latHi, double lon, double lat,
+        double cosLat, int *best, double *bestHav ) const
+{
+    if ( lo >= hi )
+    {
+        return;
+    }
+
+    // Lower bound from the latitude band
+    double dLat = 0.;
+    if ( lat < latLo )
+    {
+        dLat = latLo - lat;
+    }
+    else if ( lat > latHi )
+    {
+        dLat = lat - latHi;
+    }
+    double s = sin( 0.5 * Radians * dLat );
+    double bound = s * s;
+
+    // Lower bound from the longitude band, allowing for wrap-around
+    if ( lonHi - lonLo < 360. )
+    {
+        double east = fmod( lonLo - lon, 360. );
+        if ( east < 0. )
+        {
+            east += 360.;
+        }
+        if ( east > 0. && 360. - east > lonHi - lonLo )
+        {
+            double west = fmod( lon - lonHi, 360. );
+            if ( west < 0. )
+            {
+                west += 360.;
+            }
+            double gap = ( east < west ) ? east : west;
+            double sg = ( gap < 90. ) ? sin( Radians * gap ) : 1.;
+            double cd = sqrt( 1. - cosLat * cosLat * sg * sg );
+            double hav = 0.5 * ( 1. - cd );
+            if ( hav > bound )
+            {
+                bound = hav;
+            }
+        }
+    }
+    if ( bound >= *bestHav )
+    {
+        return;
+    }
+
+    // Test this node's site
+    int m = ( lo + hi ) / 2;
+    int site = m_tree[m];
+    double sp = sin( 0.5 * Radians * ( m_lat[site] - lat ) );
+    double sl = sin( 0.5 * Radians * ( m_lon[site] - lon ) );
+    double hav = sp * sp + cosLat * m_cosLat[site] * sl * sl;
+    if ( hav < *bestHav )
+    {
+        *bestHav = hav;
+        *best = site;
+    }
+
+    // Search the query's side of the split first
+    int axis = depth % 2;
+    double split = key( site, axis );
+    bool lowFirst = ( ( axis ? lat : lon ) < split );
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        if ( ( pass == 0 ) == lowFirst )
+        {
+            searchNearest( lo, m, depth + 1,
+                lonLo, axis ? lonHi : split, latLo, axis ? split : latHi,
+                lon, lat, cosLat, best, bestHav );
+        }
+        else
+        {
+            searchNearest( m + 1, hi, depth + 1,
+                axis ? lonLo : split, lonHi, axis ? split : latLo, latHi,
+                lon, lat, cosLat, best, bestHav );
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the sines of the site latitudes.
+ *
+ *  \return Pointer to the array of count() latitude sines.
+ */
+
+const double *SiteRegistry::sinLatitudes( void ) const
+{
+    return( m_sinLat );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the position of the sun at every site.
+ *
+ *  The results are identical to CDT_SunPositionEph() for each site.
+ *
+ *  \param eph Pointer to a solar ephemeris from CDT_SunEphemerisInit().
+ *  \param altitude Returned array of count() sun altitudes in degrees.
+ *  \param azimuth Returned array of count() sun azimuths in degrees
+ *  clockwise from north, or NULL if not wanted.
+ *
+ *  \sa CDT_SunPositionEph().
+ */
+
+void SiteRegistry::sunPosition( const struct CDT_SunEphemeris *eph,
+        double *altitude, double *azimuth ) const
+{
+    CDT_SkyPositionArray( eph->gmst, eph->ra, eph->sinDec, eph->cosDec,
+        m_count, m_lonHours, m_sinLat, m_cosLat, altitude, azimuth );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the sites within a longitude-latitude box.
+ *
+ *  If \a lonMin is greater than \a lonMax, the box is taken to span the
+ *  antimeridian.  Sites are returned in no particular order.
+ *
+ *  \param lonMin Minimum longitude in degrees (west is positive).
+ *  \param latMin Minimum latitude in degrees.
+ *  \param lonMax Maximum longitude in degrees.
+ *  \param latMax Maximum latitude in degrees.
+ *  \param sites Array to receive up to \a maxSites site indices.
+ *  \param maxSites Size of the \a sites array.
+ *
+ *  \return Total number of sites within the box, which may exceed
+ *  \a maxSites.
+ */
+
+int SiteRegistry::within( double lonMin, double latMin, double lonMax,
+        double latMax, int *sites, int maxSites ) const
+{
+    int found = 0;
+    if ( m_indexed )
+    {
+        searchBox( 0, m_count, 0, lonMin, latMin, lonMax, latMax,
+            sites, maxSites, &found );
+        return( found );
+    }
+    bool wrap = ( lonMin > lonMax );
+    for ( int i = 0; i < m_count; i++ )
+    {
+        double lon = m_lon[i];
+        if ( m_lat[i] >= latMin && m_lat[i] <= latMax
+          && ( wrap ? ( lon >= lonMin || lon <= lonMax )
+                    : ( lon >= lonMin && lon <= lonMax ) ) )
+        {
+            if ( found < maxSites )
+            {
+                sites[found] = i;
+            }
+            found++;
+        }
+    }
+    return( found );
+}
+
+//------------------------------------------------------------------------------
+//  End of siteregistry.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*! \file siteregistry.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Site registry C++ API header.
+ *
+ *  The SiteRegistry class stores many GeoPositions in a form suited to the
+ *  Calendar-Date-Time Library batch routines in cdtlib.c.
+ */
+
+#ifndef _SITEREGISTRY_H_
+/*! \def _SITEREGISTRY_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _SITEREGISTRY_H_ 1
+
+// Custom include files
+#include "geoposition.h"
+
+// Forward structure references
+struct CDT_MoonEphemeris;
+struct CDT_SunEphemeris;
+
+//------------------------------------------------------------------------------
+/*! \class SiteRegistry siteregistry.h
+ *
+ *  \brief Registry of fixed sites with cached latitude trigonometry and a
+ *  spatial index.
+ *
+ *  Sites never move, so each site's longitude in hours and the sine and
+ *  cosine of its latitude are computed once by add() and kept in parallel
+ *  arrays (structure-of-arrays), which are handed directly to
+ *  CDT_SkyPositionArray() by sunPosition() and moonPosition().
+ *
+ *  buildIndex() arranges the sites into an implicit 2-d tree on longitude
+ *  and latitude, after which nearest() and within() need only visit the
+ *  nodes that could hold a match.  Adding a site invalidates the index;
+ *  the queries fall back to a linear scan until it is rebuilt.
+ *
+ *  Site indices are the order in which the sites were added, and are not
+ *  changed by buildIndex().
+ */
+
+class SiteRegistry
+{
+// Public methods
+public:
+    SiteRegistry( int capacity=0 ) ;
+    ~SiteRegistry( void ) ;
+
+    int      add( const GeoPosition &site ) ;
+    int      add( double longitude, double latitude, double gmtDiff ) ;
+    void     buildIndex( void ) ;
+    void     clear( void ) ;
+    const double *cosLatitudes( void ) const ;
+    int      count( void ) const ;
+    double   gmtDiff( int site ) const ;
+    bool     indexed( void ) const ;
+    double   latitude( int site ) const ;
+    const double *latitudes( void ) const ;
+    double   longitude( int site ) const ;
+    const double *longitudeHours( void ) const ;
+    const double *longitudes( void ) const ;
+    void     moonPosition( const struct CDT_MoonEphemeris *eph,
+                double *altitude, double *azimuth ) const ;
+    int      nearest( double longitude, double latitude,
+                double *distance=0 ) const ;
+    GeoPosition position( int site ) const ;
+    const double *sinLatitudes( void ) const ;
+    void     sunPosition( const struct CDT_SunEphemeris *eph,
+                double *altitude, double *azimuth ) const ;
+    int      within( double lonMin, double latMin, double lonMax,
+                double latMax, int *sites, int maxSites ) const ;
+
+// Private methods
+private:
+    SiteRegistry( const SiteRegistry &sr ) ;
+    SiteRegistry &operator=( const SiteRegistry &sr ) ;
+    double   key( int site, int axis ) const ;
+    void     partition( int lo, int hi, int depth ) ;
+    void     reserve( int capacity ) ;
+    void     searchBox( int lo, int hi, int depth, double lonMin,
+                double latMin, double lonMax, double latMax, int *sites,
+                int maxSites, int *found ) const ;
+    void     searchNearest( int lo, int hi, int depth, double lonLo,
+                double lonHi, double latLo, double latHi, double lon,
+                double lat, double cosLat, int *best, double *bestHav ) const ;
+
+// Protected member data
+protected:
+    /*! \var int m_count
+        \brief Number of sites in the registry.
+    */
+    int     m_count;
+    /*! \var int m_capacity
+        \brief Number of sites allocated to each array.
+    */
+    int     m_capacity;
+    /*! \var double *m_lon
+        \brief Site longitudes in degrees (west is positive).
+    */
+    double *m_lon;
+    /*! \var double *m_lat
+        \brief Site latitudes in degrees (north is positive).
+    */
+    double *m_lat;
+    /*! \var double *m_gmt
+        \brief Site local time differences from GMT in hours.
+    */
+    double *m_gmt;
+    /*! \var double *m_lonHours
+        \brief Site longitudes divided by 15 (sidereal hours west).
+    */
+    double *m_lonHours;
+    /*! \var double *m_sinLat
+        \brief Sines of the site latitudes.
+    */
+    double *m_sinLat;
+    /*! \var double *m_cosLat
+        \brief Cosines of the site latitudes.
+    */
+    double *m_cosLat;
+    /*! \var int *m_location
+        \brief Site location name NamePool handles.
+    */
+    int    *m_location;
+    /*! \var int *m_zone
+        \brief Site time zone name NamePool handles.
+    */
+    int    *m_zone;
+    /*! \var int *m_tree
+        \brief Site indices in implicit 2-d tree order; the median of each
+        range is the node splitting it, on longitude at even depths and on
+        latitude at odd depths.
+    */
+    int    *m_tree;
+    /*! \var bool m_indexed
+        \brief TRUE if #m_tree is current.
+    */
+    bool    m_indexed;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of siteregistry.h
+//------------------------------------------------------------------------------
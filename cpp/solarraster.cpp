@@ -0,0 +1,388 @@
+//------------------------------------------------------------------------------
+/*! \file solarraster.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Terrain raster solar radiation C++ source code.
+ *
+ *  The SolarRaster class applies the Calendar-Date-Time Library solar
+ *  radiation model in cdtlib.c to every cell of a terrain raster.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "horizonmap.h"
+#include "solarraster.h"
+
+// Standard include files
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new SolarRaster with default values.
+ *
+ *  \arg all cells at 0 degrees latitude and longitude,
+ *  \arg canopy and cloud transmittance of 1 (no shading),
+ *  \arg atmospheric transparency of 0.75 (average clear forest atmosphere),
+ *  \arg 64 x 64 cell processing tiles.
+ *
+ *  setTerrain() must be called before radiation().
+ *
+ *  \param rows Number of raster rows.
+ *  \param cols Number of raster columns.
+ */
+
+SolarRaster::SolarRaster( int rows, int cols ) :
+    m_rows(rows),
+    m_cols(cols),
+    m_tile(64),
+    m_normal(0),
+    m_elevFactor(0),
+    m_lonGrid(0),
+    m_latGrid(0),
+    m_canopyGrid(0),
+    m_cloudGrid(0),
+    m_horizon(0),
+    m_lon(0.),
+    m_lat(0.),
+    m_canopy(1.),
+    m_cloud(1.),
+    m_atm(0.75)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief SolarRaster destructor.
+ *
+ *  The derived terrain grids are released; the borrowed grids are not.
+ */
+
+SolarRaster::~SolarRaster( void )
+{
+    delete[] m_normal;
+    delete[] m_elevFactor;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of raster cells.
+ *
+ *  \return Number of raster cells (rows * cols).
+ */
+
+int SolarRaster::cells( void ) const
+{
+    return( m_rows * m_cols );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of raster columns.
+ *
+ *  \return Number of raster columns.
+ */
+
+int SolarRaster::cols( void ) const
+{
+    return( m_cols );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the proportion of the solar radiation constant arriving
+ *  at the forest floor of every cell for each of the \a times dates.
+ *
+ *  Calls CDT_SunEphemerisArray() once for all the dates, then
+ *  CDT_SolarRadiationNormal() for each cell and date, tile by tile.  When
+ *  every cell shares one position the sun vector is also computed just once
+ *  per date.  If a HorizonMap is attached, cells whose local horizon hides
+ *  the sun are set to zero.
+ *
+ *  Results agree with CDT_SolarRadiation() to the single precision of the
+ *  stored terrain normals.
+ *
+ *  \param times Number of dates.
+ *  \param jdate Array of \a times Julian date-times.
+ *  \param gmtDiff Local time difference from GMT (local=GMT+gmtDiff).
+ *  \param fraction Returned array of \a times * cells() radiation fractions
+ *  [0..1] arranged as \a times consecutive row-major rasters.
+ *
+ *  \return TRUE if the radiation grids were computed,
+ *  FALSE if the terrain has not been set.
+ */
+
+bool SolarRaster::radiation( int times, const double *jdate, double gmtDiff,
+        double *fraction ) const
+{
+    if ( ! m_normal || ! m_elevFactor )
+    {
+        return( false );
+    }
+
+    // Compute the solar ephemeris for each date just once
+    CDT_SunEphemeris *eph = new CDT_SunEphemeris[ ( times > 0 ) ? times : 1 ];
+    CDT_SunEphemerisArray( times, jdate, gmtDiff, eph );
+
+    // If all cells share a position, they also share the sun vector
+    bool shared = ( ! m_lonGrid || ! m_latGrid );
+    double *sunv = new double[ 3 * ( ( times > 0 ) ? times : 1 ) ];
+    if ( shared )
+    {
+        for ( int t = 0; t < times; t++ )
+        {
+            CDT_SunVectorEph( &eph[t], m_lon, m_lat, &sunv[3*t] );
+        }
+    }
+
+    // Process the raster tile by tile, doing every date for a tile
+    int cells = m_rows * m_cols;
+    for ( int r0 = 0; r0 < m_rows; r0 += m_tile )
+    {
+        int r1 = ( r0 + m_tile < m_rows ) ? r0 + m_tile : m_rows;
+        for ( int c0 = 0; c0 < m_cols; c0 += m_tile )
+        {
+            int c1 = ( c0 + m_tile < m_cols ) ? c0 + m_tile : m_cols;
+            for ( int t = 0; t < times; t++ )
+            {
+                double *out = fraction + (ptrdiff_t) t * cells;
+                double sun[3];
+                const double *s = &sunv[3*t];
+                int sector = ( m_horizon && shared )
+                           ? m_horizon->sector( s )
+                           : 0;
+                for ( int row = r0; row < r1; row++ )
+                {
+                    for ( int col = c0; col < c1; col++ )
+                    {
+                        int i = row * m_cols + col;
+                        if ( ! shared )
+                        {
+                            CDT_SunVectorEph( &eph[t], m_lonGrid[i],
+                                m_latGrid[i], sun );
+                            s = sun;
+                            if ( m_horizon )
+                            {
+                                sector = m_horizon->sector( s );
+                            }
+                        }
+                        if ( m_horizon
+                          && ! m_horizon->isSunlit( i, sector, s[2] ) )
+                        {
+                            out[i] = 0.;
+                            continue;
+                        }
+                        out[i] = CDT_SolarRadiationNormal( s, &m_normal[i],
+                            m_elevFactor[i], m_atm,
+                            ( m_cloudGrid ) ? m_cloudGrid[i] : m_cloud,
+                            ( m_canopyGrid ) ? m_canopyGrid[i] : m_canopy );
+                    }
+                }
+            }
+        }
+    }
+    delete[] sunv;
+    delete[] eph;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of raster rows.
+ *
+ *  \return Number of raster rows.
+ */
+
+int SolarRaster::rows( void ) const
+{
+    return( m_rows );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the atmospheric transparency coefficient for all cells.
+ *
+ *  \param transparency The atmospheric transparency coefficient ([0.6-0.8])
+ *  \arg 0.80 Exceptionally clear atmosphere
+ *  \arg 0.75 Average clear forest atmosphere
+ *  \arg 0.70 Moderate forest (blue) haze
+ *  \arg 0.60 Dense haze
+ */
+
+void SolarRaster::setAtmTransparency( double transparency )
+{
+    m_atm = transparency;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a single canopy transmittance factor for all cells.
+ *
+ *  \param transmittance The canopy transmittance factor [0..1].
+ */
+
+void SolarRaster::setCanopyTransmittance( double transmittance )
+{
+    m_canopy = transmittance;
+    m_canopyGrid = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a canopy transmittance grid.
+ *
+ *  \param grid Pointer to a borrowed row-major grid of canopy transmittance
+ *  factors [0..1].
+ */
+
+void SolarRaster::setCanopyTransmittance( const double *grid )
+{
+    m_canopyGrid = grid;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a single cloud transmittance factor for all cells.
+ *
+ *  \param transmittance The cloud transmittance factor [0..1].
+ */
+
+void SolarRaster::setCloudTransmittance( double transmittance )
+{
+    m_cloud = transmittance;
+    m_cloudGrid = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a cloud transmittance grid.
+ *
+ *  \param grid Pointer to a borrowed row-major grid of cloud transmittance
+ *  factors [0..1].
+ */
+
+void SolarRaster::setCloudTransmittance( const double *grid )
+{
+    m_cloudGrid = grid;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Attaches a topographic horizon map for cast shadows.
+ *
+ *  \param horizon Pointer to a borrowed HorizonMap computed for this raster's
+ *  DEM, or NULL to apply only slope self-shading.
+ *
+ *  \return TRUE if the horizon map was attached,
+ *  FALSE if its dimensions do not match the raster (it is then ignored).
+ */
+
+bool SolarRaster::setHorizon( const HorizonMap *horizon )
+{
+    if ( horizon
+      && ( horizon->rows() != m_rows || horizon->cols() != m_cols ) )
+    {
+        m_horizon = 0;
+        return( false );
+    }
+    m_horizon = horizon;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Places every cell at the same global position.
+ *
+ *  Suitable for landscapes small enough that the sun position does not vary
+ *  appreciably across them.
+ *
+ *  \param longitude Longitude in degrees (west of Greenwich is positive).
+ *  \param latitude Latitude in degrees (north of the equator is positive).
+ */
+
+void SolarRaster::setPosition( double longitude, double latitude )
+{
+    m_lon = longitude;
+    m_lat = latitude;
+    m_lonGrid = 0;
+    m_latGrid = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets per-cell longitude and latitude grids.
+ *
+ *  Both grids must be set for them to be used; otherwise every cell is
+ *  placed at the position passed to setPosition(double,double).
+ *
+ *  \param longitude Pointer to a borrowed row-major grid of longitudes
+ *  in degrees (west of Greenwich is positive).
+ *  \param latitude Pointer to a borrowed row-major grid of latitudes
+ *  in degrees (north of the equator is positive).
+ */
+
+void SolarRaster::setPosition( const double *longitude, const double *latitude )
+{
+    m_lonGrid = longitude;
+    m_latGrid = latitude;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the terrain grids.
+ *
+ *  The grids are reduced here, once, to per-cell terrain unit normals
+ *  (CDT_TerrainNormalArray()) and air mass elevation factors
+ *  (CDT_AirMassElevationFactor()), so they are \e not retained and must be
+ *  passed again if the terrain changes.
+ *
+ *  \param elevation Pointer to a row-major grid of elevations (m).
+ *  \param slope Pointer to a row-major grid of slopes (degrees).
+ *  \param aspect Pointer to a row-major grid of aspects
+ *  (downslope direction in degrees clockwise from north).
+ */
+
+void SolarRaster::setTerrain( const double *elevation, const double *slope,
+        const double *aspect )
+{
+    int cells = m_rows * m_cols;
+    delete[] m_normal;
+    delete[] m_elevFactor;
+    m_normal = new CDT_Normal[ cells ];
+    m_elevFactor = new double[ cells ];
+    CDT_TerrainNormalArray( cells, slope, aspect, m_normal );
+    for ( int i = 0; i < cells; i++ )
+    {
+        m_elevFactor[i] = CDT_AirMassElevationFactor( elevation[i] );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the edge length of the square processing tiles.
+ *
+ *  The default of 64 keeps a tile's terrain, position, and transmittance
+ *  grids (under 64 bytes per cell) within a typical 256 KB L2 cache.
+ *
+ *  \param cells Tile edge length in cells (values less than 1 are ignored).
+ */
+
+void SolarRaster::setTileSize( int cells )
+{
+    if ( cells > 0 )
+    {
+        m_tile = cells;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the edge length of the square processing tiles.
+ *
+ *  \return Tile edge length in cells.
+ */
+
+int SolarRaster::tileSize( void ) const
+{
+    return( m_tile );
+}
+
+//------------------------------------------------------------------------------
+//  End of solarraster.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+/*! \file solarraster.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Terrain raster solar radiation C++ API header.
+ *
+ *  The SolarRaster class applies the Calendar-Date-Time Library solar
+ *  radiation model in cdtlib.c to every cell of a terrain raster.
+ */
+
+#ifndef _SOLARRASTER_H_
+/*! \def _SOLARRASTER_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _SOLARRASTER_H_ 1
+
+// Forward class references
+class HorizonMap;
+
+// Forward structure references
+struct CDT_Normal;
+
+//------------------------------------------------------------------------------
+/*! \class SolarRaster solarraster.h
+ *
+ *  \brief Determines the proportion of the solar radiation constant arriving
+ *  at the forest floor for every cell of a terrain raster and for each of a
+ *  list of times.
+ *
+ *  The raster is stored in row-major order (row 0 is the northern edge).
+ *  The position and transmittance grids are \e borrowed, not copied; they
+ *  must remain valid until the last call to radiation().
+ *
+ *  The solar ephemeris for each time is computed once and shared by every
+ *  cell.  The static terrain is reduced once by setTerrain() to per-cell
+ *  unit normals and air mass elevation factors, so the sun-to-slope
+ *  incidence is a single dot product per cell and time.  Cells are processed
+ *  in square tiles, and every time is evaluated for a tile before moving to
+ *  the next one, so each tile's terrain stays in cache for the whole time
+ *  series.
+ *
+ *  If a HorizonMap is attached by setHorizon(), cells whose local horizon
+ *  hides the sun receive no direct radiation (cast shadows); otherwise only
+ *  slope self-shading is applied.
+ *
+ *  \sa CDT_SolarRadiation(), CDT_SolarRadiationNormal().
+ */
+
+class SolarRaster
+{
+// Public methods
+public:
+    SolarRaster( int rows, int cols ) ;
+    ~SolarRaster( void ) ;
+
+    int      cells( void ) const ;
+    int      cols( void ) const ;
+    bool     radiation( int times, const double *jdate, double gmtDiff,
+                double *fraction ) const ;
+    int      rows( void ) const ;
+    void     setAtmTransparency( double transparency ) ;
+    void     setCanopyTransmittance( double transmittance ) ;
+    void     setCanopyTransmittance( const double *grid ) ;
+    void     setCloudTransmittance( double transmittance ) ;
+    void     setCloudTransmittance( const double *grid ) ;
+    bool     setHorizon( const HorizonMap *horizon ) ;
+    void     setPosition( double longitude, double latitude ) ;
+    void     setPosition( const double *longitude, const double *latitude ) ;
+    void     setTerrain( const double *elevation, const double *slope,
+                const double *aspect ) ;
+    void     setTileSize( int cells ) ;
+    int      tileSize( void ) const ;
+
+// Private methods
+private:
+    SolarRaster( const SolarRaster &sr ) ;
+    SolarRaster &operator=( const SolarRaster &sr ) ;
+
+// Protected member data
+protected:
+    /*! \var int m_rows
+        \brief Number of raster rows.
+    */
+    int     m_rows;
+    /*! \var int m_cols
+        \brief Number of raster columns.
+    */
+    int     m_cols;
+    /*! \var int m_tile
+        \brief Edge length of the square processing tiles in cells.
+    */
+    int     m_tile;
+    /*! \var CDT_Normal *m_normal
+        \brief Owned grid of terrain unit normals derived from the slope and
+        aspect grids by setTerrain().
+    */
+    CDT_Normal *m_normal;
+    /*! \var double *m_elevFactor
+        \brief Owned grid of air mass elevation factors derived from the
+        elevation grid by setTerrain().
+    */
+    double *m_elevFactor;
+    /*! \var const double *m_lonGrid
+        \brief Optional borrowed longitude grid (degrees, west is positive).
+        If NULL, #m_lon applies to every cell.
+    */
+    const double *m_lonGrid;
+    /*! \var const double *m_latGrid
+        \brief Optional borrowed latitude grid (degrees, north is positive).
+        If NULL, #m_lat applies to every cell.
+    */
+    const double *m_latGrid;
+    /*! \var const double *m_canopyGrid
+        \brief Optional borrowed canopy transmittance grid [0..1].
+        If NULL, #m_canopy applies to every cell.
+    */
+    const double *m_canopyGrid;
+    /*! \var const double *m_cloudGrid
+        \brief Optional borrowed cloud transmittance grid [0..1].
+        If NULL, #m_cloud applies to every cell.
+    */
+    const double *m_cloudGrid;
+    /*! \var const HorizonMap *m_horizon
+        \brief Optional borrowed horizon map for cast shadows, or NULL.
+    */
+    const HorizonMap *m_horizon;
+    /*! \var double m_lon
+        \brief Longitude of every cell when #m_lonGrid is NULL.
+    */
+    double  m_lon;
+    /*! \var double m_lat
+        \brief Latitude of every cell when #m_latGrid is NULL.
+    */
+    double  m_lat;
+    /*! \var double m_canopy
+        \brief Canopy transmittance of every cell when #m_canopyGrid is NULL.
+    */
+    double  m_canopy;
+    /*! \var double m_cloud
+        \brief Cloud transmittance of every cell when #m_cloudGrid is NULL.
+    */
+    double  m_cloud;
+    /*! \var double m_atm
+        \brief Atmospheric transparency coefficient [0.6-0.8].
+    */
+    double  m_atm;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of solarraster.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+/*! \file systemclock.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Reentrant high-resolution system clock C++ source code.
+ *
+ *  The SystemClock class reads the current UTC time for DateTime, TimeStamp,
+ *  and the Calendar-Date-Time Library in cdtlib.c.
+ */
+
+// Custom include files
+#include "systemclock.h"
+#include "timestamp.h"
+
+// Standard include files
+#include <time.h>
+
+/*! \def CDT_THREAD
+    \internal
+    \brief Declares a variable with one instance per thread.
+ */
+#if defined(_MSC_VER)
+#define CDT_THREAD __declspec(thread)
+#else
+#define CDT_THREAD __thread
+#endif
+
+/*! \var CachedSeconds
+    \brief Unix seconds of the calling thread's last clock reading,
+    or 0 if the thread has not read the clock.
+ */
+static CDT_THREAD long long CachedSeconds = 0;
+
+/*! \var CachedNanoseconds
+    \brief Nanoseconds of the second of the calling thread's last clock
+    reading.
+ */
+static CDT_THREAD long CachedNanoseconds = 0;
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the real-time clock into the calling thread's cache.
+ *
+ *  \param coarse TRUE to read the coarse clock if the system has one.
+ */
+
+static void ReadClock( bool coarse )
+{
+    struct timespec ts;
+#if defined(CLOCK_REALTIME_COARSE)
+    clock_gettime( coarse ? CLOCK_REALTIME_COARSE : CLOCK_REALTIME, &ts );
+#elif defined(CLOCK_REALTIME)
+    (void) coarse;
+    clock_gettime( CLOCK_REALTIME, &ts );
+#else
+    (void) coarse;
+    timespec_get( &ts, TIME_UTC );
+#endif
+    CachedSeconds = (long long) ts.tv_sec;
+    CachedNanoseconds = (long) ts.tv_nsec;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts the calling thread's cached reading into a UTC Julian
+ *  date.
+ *
+ *  \return UTC Julian date.
+ */
+
+static double CachedJulianDate( void )
+{
+    return( 2440587.5 + (double) CachedSeconds / 86400.
+          + (double) CachedNanoseconds / 86400e9 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts the calling thread's cached reading into milliseconds
+ *  since the TimeStamp epoch.
+ *
+ *  \return Milliseconds since the TimeStamp epoch, truncated.
+ */
+
+static long long CachedMilliseconds( void )
+{
+    return( SystemClock::UnixEpoch + 1000LL * CachedSeconds
+          + CachedNanoseconds / 1000000L );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the UTC Julian date of the calling thread's last clock
+ *  reading, without reading the clock.
+ *
+ *  The precise clock is read if this thread has not yet read either clock.
+ *
+ *  \return UTC Julian date.
+ */
+
+double SystemClock::cachedJulianDate( void )
+{
+    if ( CachedSeconds == 0 )
+    {
+        ReadClock( false );
+    }
+    return( CachedJulianDate() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the milliseconds since the TimeStamp epoch of the calling
+ *  thread's last clock reading, without reading the clock.
+ *
+ *  The precise clock is read if this thread has not yet read either clock.
+ *
+ *  \return UTC milliseconds since the TimeStamp epoch.
+ */
+
+long long SystemClock::cachedMilliseconds( void )
+{
+    if ( CachedSeconds == 0 )
+    {
+        ReadClock( false );
+    }
+    return( CachedMilliseconds() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the coarse clock and gets its UTC Julian date.
+ *
+ *  \return UTC Julian date, with a resolution of the system's scheduler
+ *  tick (or better where there is no coarse clock).
+ */
+
+double SystemClock::coarseJulianDate( void )
+{
+    ReadClock( true );
+    return( CachedJulianDate() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the coarse clock and gets its milliseconds since the
+ *  TimeStamp epoch.
+ *
+ *  \return UTC milliseconds since the TimeStamp epoch, with a resolution of
+ *  the system's scheduler tick (or better where there is no coarse clock).
+ */
+
+long long SystemClock::coarseMilliseconds( void )
+{
+    ReadClock( true );
+    return( CachedMilliseconds() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the precise clock and gets its UTC Julian date.
+ *
+ *  \return UTC Julian date.  The clock resolution is normally better than a
+ *  microsecond, but a Julian date near the present resolves only about 40
+ *  microseconds.
+ */
+
+double SystemClock::julianDate( void )
+{
+    ReadClock( false );
+    return( CachedJulianDate() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the precise clock and gets its milliseconds since the
+ *  TimeStamp epoch.
+ *
+ *  \return UTC milliseconds since the TimeStamp epoch.
+ */
+
+long long SystemClock::milliseconds( void )
+{
+    ReadClock( false );
+    return( CachedMilliseconds() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the precise clock into a TimeStamp.
+ *
+ *  \return TimeStamp of the current UTC time.
+ */
+
+TimeStamp SystemClock::timeStamp( void )
+{
+    TimeStamp ts;
+    ts.addMilliseconds( milliseconds() );
+    return( ts );
+}
+
+//------------------------------------------------------------------------------
+//  End of systemclock.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+/*! \file systemclock.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Reentrant high-resolution system clock C++ API header.
+ *
+ *  The SystemClock class reads the current UTC time for DateTime, TimeStamp,
+ *  and the Calendar-Date-Time Library in cdtlib.c.
+ */
+
+#ifndef _SYSTEMCLOCK_H_
+/*! \def _SYSTEMCLOCK_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _SYSTEMCLOCK_H_ 1
+
+// Custom include files
+#include "timestamp.h"
+
+//------------------------------------------------------------------------------
+/*! \class SystemClock systemclock.h
+ *
+ *  \brief Current UTC time with millisecond or better resolution.
+ *
+ *  All the methods are static and reentrant.  The clock is read with
+ *  clock_gettime() (or the system's equivalent); no C library time zone or
+ *  static struct tm state is touched.
+ *
+ *  Three grades of clock are offered:
+ *  \arg julianDate() and milliseconds() read the precise real-time clock.
+ *  \arg coarseJulianDate() and coarseMilliseconds() read the coarse
+ *  real-time clock where the system has one (Linux CLOCK_REALTIME_COARSE).
+ *  It advances once per scheduler tick, a few milliseconds, but is read
+ *  without entering the kernel, so it suits timestamps taken at high
+ *  frequency.
+ *  \arg cachedJulianDate() and cachedMilliseconds() read nothing.  They
+ *  return the time from the calling thread's last reading of either clock,
+ *  so a batch of records can share one reading.
+ *
+ *  \sa DateTime::setSystem(), TimeStamp
+ */
+
+class SystemClock
+{
+// Public methods
+public:
+    static long long cachedMilliseconds( void ) ;
+    static double    cachedJulianDate( void ) ;
+    static long long coarseMilliseconds( void ) ;
+    static double    coarseJulianDate( void ) ;
+    static double    julianDate( void ) ;
+    static long long milliseconds( void ) ;
+    static TimeStamp timeStamp( void ) ;
+
+    /*! \var UnixEpoch
+        \brief Milliseconds from the TimeStamp epoch to the Unix epoch
+        (midnight, Jan 1, 1970 UTC).
+    */
+    static const long long UnixEpoch = 210866803200000LL;
+
+// Private methods
+private:
+    SystemClock( void ) ;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of systemclock.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+/*----------------------------------------------------------------------------*/
+/*! \file chebyshevtest.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Regression test of ChebyshevEphemeris::riseSet() against
+ *  CDT_RiseSet().
+ *
+ *  Solar and lunar fits with the default segments are made over 2023
+ *  through 2026, and ChebyshevEphemeris::verifyRiseSet() compares every
+ *  rise, set, dawn, and dusk of every local date in the span at
+ *  equatorial, mid-, and polar latitudes in both hemispheres.  Every
+ *  #CDT_Flag result must match CDT_RiseSet(), and every event time must be
+ *  within 0.001 minutes of it.
+ *
+ *  Build and run from the cpp directory with
+ *
+ *      g++ -O2 -I. tests/chebyshevtest.cpp chebyshev.cpp cdtlib.cpp \
+ *          -o chebyshevtest
+ *      ./chebyshevtest
+ *
+ *  The program prints a summary and exits with a non-zero status on failure.
+ */
+
+/* Custom include files */
+#include "cdtlib.h"
+#include "chebyshev.h"
+
+/* Standard include files */
+#include <stdio.h>
+
+/*! \var static const double Tolerance
+ *  \brief Largest allowed event time difference in minutes.
+ */
+static const double Tolerance = 0.001;
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Verifies the solar and lunar fits at a range of sites.
+ *
+ *  \return 0 if every event agrees, 1 otherwise.
+ */
+
+int main( void )
+{
+    static const double Lat[] = { 0., 23., -23., 45., -45., 60., -60., 69.,
+        -69., 75., -75., 85., -85. };
+    static const double Lon[] = { -114., 0., 151. };
+    double jd0, days, gmtDiff, maxMinutes;
+    int body, i, j, events, mismatches;
+    long compared, failures;
+
+    jd0 = CDT_JulianDate( 2023, 1, 1, 0, 0, 0, 0 );
+    days = CDT_JulianDate( 2027, 1, 1, 0, 0, 0, 0 ) - jd0;
+    compared = failures = 0;
+    for ( body = 0; body < 2; body++ )
+    {
+        ChebyshevEphemeris fit( jd0, days, body == 1 );
+        for ( i = 0; i < (int) ( sizeof(Lat) / sizeof(Lat[0]) ); i++ )
+        {
+            for ( j = 0; j < (int) ( sizeof(Lon) / sizeof(Lon[0]) ); j++ )
+            {
+                gmtDiff = -Lon[j] / 15.;
+                events = fit.verifyRiseSet( Lon[j], Lat[i], gmtDiff,
+                    &maxMinutes, &mismatches );
+                compared += events;
+                if ( mismatches || maxMinutes > Tolerance )
+                {
+                    failures++;
+                    printf( "%s lat %g lon %g: %d events, %d flag "
+                        "mismatches, max difference %.5f minutes\n",
+                        body ? "Moon" : "Sun", Lat[i], Lon[j], events,
+                        mismatches, maxMinutes );
+                }
+            }
+        }
+    }
+    printf( "%ld events, %ld failing sites\n", compared, failures );
+    return( failures ? 1 : 0 );
+}
+
+/*----------------------------------------------------------------------------*/
+/*  End of chebyshevtest.cpp                                                  */
+/*----------------------------------------------------------------------------*/
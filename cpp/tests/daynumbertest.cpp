@@ -0,0 +1,273 @@
+/*----------------------------------------------------------------------------*/
+/*! \file daynumbertest.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Round-trip test of the integer day-number calendar core.
+ *
+ *  CDT_DayNumber(), CDT_DayNumberDate(), CDT_JulianDateSplit(), and
+ *  CDT_MillisecondTime() are checked against themselves and against
+ *  reference copies of the truncating CDT_JulianDate() and
+ *  CDT_CalendarDate() that preceded them:
+ *
+ *  \arg Every date from -4712 through 9999 must round-trip through
+ *  CDT_DayNumber() and CDT_DayNumberDate(), and CDT_JulianDate() at noon
+ *  must equal the day number.
+ *  \arg The reference CDT_JulianDate() must be bit-identical for years 1
+ *  and later.  For earlier years it truncated (365.25 * year) toward zero,
+ *  putting non-leap years a day late; those intended differences are
+ *  counted, and must be exactly one day.
+ *  \arg CDT_DayNumberDate() must give the reference CDT_CalendarDate()
+ *  date for every day number from 0 through 6,000,000.
+ *  \arg Every millisecond of a day, and hourly times across the whole range,
+ *  must round-trip through CDT_JulianDate(), CDT_JulianDateSplit(), and
+ *  CDT_MillisecondTime().
+ *
+ *  Build and run from the cpp directory with
+ *
+ *      g++ -O2 -I. tests/daynumbertest.cpp cdtlib.cpp -o daynumbertest
+ *      ./daynumbertest
+ *
+ *  The program prints a summary and exits with a non-zero status on failure.
+ */
+
+/* Custom include files */
+#include "cdtlib.h"
+
+/* Standard include files */
+#include <stdio.h>
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Reference copy of the previous, truncating CDT_CalendarDate().
+ *
+ *  Only the date is returned; the truncated time is not compared.
+ *
+ *  \param jdate Julian date.
+ *  \param *year Returned Julian-Gregorian year.
+ *  \param *month Returned month of the year (1-12).
+ *  \param *day Returned day of the month (1-31).
+ */
+
+static void ReferenceCalendarDate( double jdate, int *year, int *month,
+            int *day )
+{
+    int b, d, f;
+    double jd0, c, e;
+
+    jd0 = (double) ( (long) ( jdate + 0.5 ) );
+
+    if ( jd0 < 2299161.0 )
+    {
+        c = jd0 + 1524.0;
+    }
+    else
+    {
+        b = (int) ( ( jd0 - 1867216.25 ) / 36524.25 );
+        c = jd0 + (b - (int) ( b / 4 ) ) + 1525.0;
+    }
+    d = (int) ( (c - 122.1) / 365.25 );
+    e = 365.0 * d + (int) ( d / 4 );
+    f = (int) ( (c - e) / 30.6001 );
+
+    *day = (int) ( c - e + 0.5 ) - (int) ( 30.6001 * f );
+    *month = f - 1 - 12 * (int) ( f / 14 );
+    *year = d - 4715 - (int) ( ( 7 + *month ) / 10 );
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Reference copy of the previous, truncating CDT_JulianDate().
+ *
+ *  \param year Julian-Gregorian year.
+ *  \param month Month of the year (1-12).
+ *  \param day Day of the month (1-31).
+ *  \param hour Hours past midnight (0-23).
+ *  \param minute Minutes past the hour (0-59).
+ *  \param second Seconds past the minute (0-59).
+ *  \param millisecond Milliseconds past the second (0-999).
+ *
+ *  \return The Julian date.
+ */
+
+static double ReferenceJulianDate( int year, int month, int day,
+            int hour, int minute, int second, int millisecond )
+{
+    double jdate;
+    int a, b, c, d;
+
+    jdate = 10000 * year + 100 * month + day;
+    if ( month <= 2 )
+    {
+        year--;
+        month+= 12;
+    }
+    a = 0;
+    b = 0;
+    if ( jdate >= 15821015.0 )
+    {
+        a = (int) (year / 100);
+        b = 2 - a + (int) (a/4);
+    }
+    c = (int) (365.25 * year);
+    d = (int) (30.6001 * ( month + 1 ));
+    jdate = b + c + d + day
+          + CDT_DecimalDay( hour, minute, second, millisecond )
+          + 1720994.5;
+    return( jdate );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Round-trips one millisecond of a day through a Julian date.
+ *
+ *  \param year Julian-Gregorian year.
+ *  \param month Month of the year (1-12).
+ *  \param day Day of the month (1-31).
+ *  \param ms Millisecond of the day.
+ *
+ *  \return 1 if the round trip fails, 0 if it is exact.
+ */
+
+static int MillisecondRoundTrip( int year, int month, int day, int ms )
+{
+    int hour, minute, second, millisecond, msOfDay;
+    long jdn;
+    double jdate;
+
+    CDT_MillisecondTime( ms, &hour, &minute, &second, &millisecond );
+    if ( CDT_MillisecondOfDay( hour, minute, second, millisecond ) != ms )
+    {
+        return( 1 );
+    }
+    jdate = CDT_JulianDate( year, month, day, hour, minute, second,
+        millisecond );
+    CDT_JulianDateSplit( jdate, &jdn, &msOfDay );
+    return( jdn != CDT_DayNumber( year, month, day ) || msOfDay != ms );
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Runs the day-number round-trip and reference comparisons.
+ *
+ *  \return 0 if every check passes, 1 otherwise.
+ */
+
+int main( void )
+{
+    int year, month, day, days, y, m, d, ms, hour, minute, second;
+    int millisecond;
+    long jdn, dates, failures, msTrips, msFailures, earlyDifferences;
+    double jdate, reference;
+
+    /* Every date, -4712 through 9999 */
+    dates = failures = earlyDifferences = 0;
+    for ( year = -4712; year <= 9999; year++ )
+    {
+        for ( month = 1; month <= 12; month++ )
+        {
+            days = CDT_DaysInMonth( year, month );
+            for ( day = 1; day <= days; day++ )
+            {
+                /* The 10 days dropped by the Gregorian reform */
+                if ( year == 1582 && month == 10 && day > 4 && day < 15 )
+                {
+                    continue;
+                }
+                dates++;
+                jdn = CDT_DayNumber( year, month, day );
+                CDT_DayNumberDate( jdn, &y, &m, &d );
+                jdate = CDT_JulianDate( year, month, day, 12, 0, 0, 0 );
+                reference = ReferenceJulianDate( year, month, day,
+                    12, 0, 0, 0 );
+                if ( y != year || m != month || d != day
+                  || jdate != (double) jdn )
+                {
+                    if ( failures++ < 10 )
+                    {
+                        printf( "Date %d-%02d-%02d: day number %ld gives "
+                            "%d-%02d-%02d, Julian date %.1f\n",
+                            year, month, day, jdn, y, m, d, jdate );
+                    }
+                }
+                else if ( reference != jdate )
+                {
+                    if ( year < 1 && reference == jdate + 1. )
+                    {
+                        earlyDifferences++;
+                    }
+                    else if ( failures++ < 10 )
+                    {
+                        printf( "Date %d-%02d-%02d: Julian date %.1f, "
+                            "reference %.1f\n",
+                            year, month, day, jdate, reference );
+                    }
+                }
+            }
+        }
+    }
+    printf( "%ld dates, %ld intended reference differences before 1 A.D.\n",
+        dates, earlyDifferences );
+
+    /* Every day number, 0 through 6,000,000 */
+    for ( jdn = 0; jdn <= 6000000; jdn++ )
+    {
+        ReferenceCalendarDate( (double) jdn, &year, &month, &day );
+        CDT_DayNumberDate( jdn, &y, &m, &d );
+        if ( y != year || m != month || d != day )
+        {
+            if ( failures++ < 10 )
+            {
+                printf( "Day number %ld: %d-%02d-%02d, reference "
+                    "%d-%02d-%02d\n", jdn, y, m, d, year, month, day );
+            }
+        }
+    }
+
+    /* Times: the reference Julian date is bit-identical from 1 A.D. */
+    for ( year = 1; year <= 9999; year += 7 )
+    {
+        for ( month = 1; month <= 12; month++ )
+        {
+            for ( ms = 0; ms < 86400000; ms += 3600000 + 7919 )
+            {
+                CDT_MillisecondTime( ms, &hour, &minute, &second,
+                    &millisecond );
+                if ( CDT_JulianDate( year, month, 13, hour, minute, second,
+                        millisecond )
+                  != ReferenceJulianDate( year, month, 13, hour, minute,
+                        second, millisecond ) )
+                {
+                    if ( failures++ < 10 )
+                    {
+                        printf( "Date %d-%02d-13 ms %d: Julian date differs "
+                            "from reference\n", year, month, ms );
+                    }
+                }
+            }
+        }
+    }
+
+    /* Millisecond round trips: hourly across the range, every ms of a day */
+    msTrips = msFailures = 0;
+    for ( year = -4712; year <= 9999; year += 13 )
+    {
+        for ( ms = 0; ms < 86400000; ms += 3600000 + 37 )
+        {
+            msTrips++;
+            msFailures += MillisecondRoundTrip( year, 6, 15, ms );
+        }
+    }
+    for ( ms = 0; ms < 86400000; ms++ )
+    {
+        msTrips++;
+        msFailures += MillisecondRoundTrip( 2024, 3, 1, ms );
+    }
+    printf( "%ld millisecond round trips, %ld failures\n",
+        msTrips, msFailures );
+    failures += msFailures;
+
+    printf( "%ld failures\n", failures );
+    return( failures ? 1 : 0 );
+}
+
+/*----------------------------------------------------------------------------*/
+/*  End of daynumbertest.cpp                                                  */
+/*----------------------------------------------------------------------------*/
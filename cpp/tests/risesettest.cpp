@@ -0,0 +1,93 @@
+/*----------------------------------------------------------------------------*/
+/*! \file risesettest.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Regression test of CDT_RiseSetNewton() against CDT_RiseSet().
+ *
+ *  Every rise, set, dawn, and dusk event, moon events included, is computed
+ *  both ways every third day of 2024 at latitudes -65 through 65 and eight
+ *  longitudes.  The #CDT_Flag results must match, moon event times must be
+ *  identical (they are always scanned), and sun, dawn, and dusk times must
+ *  be within CDT_RiseSet()'s interpolation error of half a minute.
+ *
+ *  Build and run from the cpp directory with
+ *
+ *      g++ -O2 -I. tests/risesettest.cpp cdtlib.cpp -o risesettest
+ *      ./risesettest
+ *
+ *  The program prints a summary and exits with a non-zero status on failure.
+ */
+
+/* Custom include files */
+#include "cdtlib.h"
+
+/* Standard include files */
+#include <math.h>
+#include <stdio.h>
+
+/*----------------------------------------------------------------------------*/
+/*! \brief Compares CDT_RiseSetNewton() with CDT_RiseSet() over 2024.
+ *
+ *  \return 0 if every event agrees, 1 otherwise.
+ */
+
+int main( void )
+{
+    double jd0, gmtDiff, scanHours, newtonHours, minutes, maxMinutes;
+    int event, lat, lon, day, scanFlag, newtonFlag, moon;
+    long events, failures;
+
+    jd0 = CDT_JulianDate( 2024, 1, 1, 0, 0, 0, 0 );
+    events = failures = 0;
+    for ( event = CDT_SunRise; event <= CDT_AstronomicalDusk; event++ )
+    {
+        moon = ( event == CDT_MoonRise || event == CDT_MoonSet );
+        maxMinutes = 0.;
+        for ( lat = -65; lat <= 65; lat += 5 )
+        {
+            for ( lon = -180; lon < 180; lon += 45 )
+            {
+                gmtDiff = floor( -lon / 15. + 0.5 );
+                for ( day = 0; day < 366; day += 3 )
+                {
+                    scanHours = newtonHours = -1.;
+                    scanFlag = CDT_RiseSet( event, jd0 + day, lon, lat,
+                        gmtDiff, &scanHours );
+                    newtonFlag = CDT_RiseSetNewton( event, jd0 + day, lon, lat,
+                        gmtDiff, &newtonHours );
+                    events++;
+                    minutes = 0.;
+                    if ( scanFlag == CDT_Rises || scanFlag == CDT_Sets )
+                    {
+                        minutes = 60. * fabs( scanHours - newtonHours );
+                    }
+                    if ( minutes > maxMinutes )
+                    {
+                        maxMinutes = minutes;
+                    }
+                    if ( newtonFlag != scanFlag
+                      || ( moon && minutes != 0. )
+                      || minutes > 0.5 )
+                    {
+                        if ( failures++ < 10 )
+                        {
+                            printf( "Event %d lat %d lon %d day %d: "
+                                "CDT_RiseSet() %d %.4f, "
+                                "CDT_RiseSetNewton() %d %.4f\n",
+                                event, lat, lon, day, scanFlag, scanHours,
+                                newtonFlag, newtonHours );
+                        }
+                    }
+                }
+            }
+        }
+        printf( "Event %2d: max difference %.4f minutes\n", event, maxMinutes );
+    }
+    printf( "%ld events, %ld failures\n", events, failures );
+    return( failures ? 1 : 0 );
+}
+
+/*----------------------------------------------------------------------------*/
+/*  End of risesettest.cpp                                                    */
+/*----------------------------------------------------------------------------*/
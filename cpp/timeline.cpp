@@ -0,0 +1,477 @@
+//------------------------------------------------------------------------------
+/*! \file timeline.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Regular time series axis C++ source code.
+ *
+ *  The Timeline class describes the times of a regular (fixed-step) series
+ *  so that series records need not carry their own DateTime.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "timeline.h"
+#include "timestamp.h"
+
+// Standard include files
+#include <limits.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Number of cached calendar fields per Timeline index.
+ */
+
+static const int TimelineFields = 7;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a Timeline of \a count times beginning at \a start.
+ *
+ *  \param start Time of index 0.
+ *  \param stepMilliseconds Milliseconds between consecutive indices.
+ *  The Timeline is empty if this is not positive.
+ *  \param count Number of indices.
+ */
+
+Timeline::Timeline( const TimeStamp &start, long long stepMilliseconds,
+        int count ) :
+    m_start(start.milliseconds()),
+    m_step(1),
+    m_count(0),
+    m_fields(0)
+{
+    if ( stepMilliseconds > 0 && count > 0 )
+    {
+        m_step = stepMilliseconds;
+        m_count = count;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Timeline copy constructor.
+ *
+ *  The calendar field cache is not copied.
+ *
+ *  \param tl Reference to an existing Timeline.
+ */
+
+Timeline::Timeline( const Timeline &tl ) :
+    m_start(tl.m_start),
+    m_step(tl.m_step),
+    m_count(tl.m_count),
+    m_fields(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Timeline destructor.
+ */
+
+Timeline::~Timeline( void )
+{
+    delete[] m_fields;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the time at \a index.
+ *
+ *  \param index Timeline index; indices outside 0 to count()-1 extend the
+ *  Timeline in either direction.
+ *
+ *  \return TimeStamp of the index.
+ */
+
+TimeStamp Timeline::at( int index ) const
+{
+    TimeStamp ts;
+    ts.addMilliseconds( milliseconds( index ) );
+    return( ts );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets all the calendar fields of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *  \param year Returned Julian-Gregorian year.
+ *  \param month Returned month of the year (1-12).
+ *  \param day Returned day of the month (1-31).
+ *  \param hour Returned hour of the day (0-23).
+ *  \param minute Returned minute of the hour (0-59).
+ *  \param second Returned second of the minute (0-59).
+ *  \param millisecond Returned millisecond of the second (0-999).
+ *
+ *  \return The function returns nothing.
+ */
+
+void Timeline::calendarDate( int index, int *year, int *month, int *day,
+        int *hour, int *minute, int *second, int *millisecond ) const
+{
+    const int *f = fields( index );
+    *year        = f[0];
+    *month       = f[1];
+    *day         = f[2];
+    *hour        = f[3];
+    *minute      = f[4];
+    *second      = f[5];
+    *millisecond = f[6];
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of Timeline indices.
+ *
+ *  \return Number of indices.
+ */
+
+int Timeline::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the day of the month of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Day of the month (1-31).
+ */
+
+int Timeline::day( int index ) const
+{
+    return( fields( index )[2] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the cached calendar fields of \a index, computing them first
+ *  if necessary.
+ *
+ *  The cache for the whole Timeline is allocated on the first call.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Pointer to the year, month, day, hour, minute, second, and
+ *  millisecond of the index.
+ */
+
+const int *Timeline::fields( int index ) const
+{
+    if ( ! m_fields )
+    {
+        m_fields = new int[ TimelineFields * m_count ];
+        for ( int i = 0; i < TimelineFields * m_count; i++ )
+        {
+            m_fields[i] = 0;
+        }
+    }
+    int *f = m_fields + TimelineFields * index;
+    if ( f[1] == 0 )
+    {
+        long long ms = milliseconds( index );
+        long long jdn = floorDiv( ms, TimeStamp::MsPerDay );
+        CDT_DayNumberDate( (long) jdn, &f[0], &f[1], &f[2] );
+        CDT_MillisecondTime( (int) ( ms - jdn * TimeStamp::MsPerDay ),
+            &f[3], &f[4], &f[5], &f[6] );
+    }
+    return( f );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the hour of the day of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Hour of the day (0-23).
+ */
+
+int Timeline::hour( int index ) const
+{
+    return( fields( index )[3] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the index of the step containing \a ts.
+ *
+ *  \param ts Time to locate.
+ *
+ *  \return Index of the last Timeline time at or before \a ts.  This is
+ *  negative if \a ts precedes the Timeline and count() or more if it
+ *  follows the Timeline's last step, and is clamped to the int range.
+ */
+
+int Timeline::indexOf( const TimeStamp &ts ) const
+{
+    long long i = floorDiv( ts.milliseconds() - m_start, m_step );
+    if ( i < INT_MIN )
+    {
+        return( INT_MIN );
+    }
+    return( ( i > INT_MAX ) ? INT_MAX : (int) i );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the Julian date of the time at \a index.
+ *
+ *  \param index Timeline index.
+ *
+ *  \return Julian date in decimal days.
+ */
+
+double Timeline::julianDate( int index ) const
+{
+    long long ms = milliseconds( index );
+    long long jdn = floorDiv( ms, TimeStamp::MsPerDay );
+    return( (double) jdn - 0.5
+          + (double) ( ms - jdn * TimeStamp::MsPerDay ) / 86400000. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Maps every index of this Timeline onto the index of the \a tl
+ *  step containing it.
+ *
+ *  Only the first index requires a division; the rest are stepped with an
+ *  integer quotient and remainder.
+ *
+ *  \param tl Reference to the Timeline to map onto.
+ *  \param index Array of count() elements, returning for each index of this
+ *  Timeline the \a tl index of the last \a tl time at or before it (see
+ *  indexOf()).
+ *
+ *  \return Number of indices that fall within \a tl, i.e. whose mapped
+ *  index is 0 to \a tl.count()-1.
+ */
+
+int Timeline::mapIndices( const Timeline &tl, int *index ) const
+{
+    if ( m_count <= 0 )
+    {
+        return( 0 );
+    }
+    long long offset = m_start - tl.m_start;
+    long long k = floorDiv( offset, tl.m_step );
+    long long r = offset - k * tl.m_step;
+    long long q = m_step / tl.m_step;
+    long long s = m_step - q * tl.m_step;
+    int inside = 0;
+    for ( int i = 0; i < m_count; i++ )
+    {
+        index[i] = (int) k;
+        if ( k >= 0 && k < tl.m_count )
+        {
+            inside++;
+        }
+        k += q;
+        if ( ( r += s ) >= tl.m_step )
+        {
+            r -= tl.m_step;
+            k++;
+        }
+    }
+    return( inside );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the millisecond of the second of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Millisecond of the second (0-999).
+ */
+
+int Timeline::millisecond( int index ) const
+{
+    return( fields( index )[6] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the minute of the hour of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Minute of the hour (0-59).
+ */
+
+int Timeline::minute( int index ) const
+{
+    return( fields( index )[4] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the month of the year of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Month of the year (1-12).
+ */
+
+int Timeline::month( int index ) const
+{
+    return( fields( index )[1] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the indices of this Timeline whose times lie within
+ *  the first through last times of \a tl.
+ *
+ *  \param tl Reference to the other Timeline.
+ *  \param first Returned first overlapping index of this Timeline.
+ *  \param count Returned number of overlapping indices (0 if none).
+ *
+ *  \return TRUE if the Timelines overlap, FALSE if not.
+ */
+
+bool Timeline::overlap( const Timeline &tl, int *first, int *count ) const
+{
+    *first = 0;
+    *count = 0;
+    if ( m_count <= 0 || tl.m_count <= 0 )
+    {
+        return( false );
+    }
+    // First index at or after tl's start, last index at or before its end
+    long long i0 = -floorDiv( m_start - tl.m_start, m_step );
+    long long i1 = floorDiv( tl.milliseconds( tl.m_count - 1 ) - m_start,
+                    m_step );
+    if ( i0 < 0 )
+    {
+        i0 = 0;
+    }
+    if ( i1 > m_count - 1 )
+    {
+        i1 = m_count - 1;
+    }
+    if ( i1 < i0 )
+    {
+        return( false );
+    }
+    *first = (int) i0;
+    *count = (int) ( i1 - i0 + 1 );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates the Timeline with a new step that covers this Timeline.
+ *
+ *  The new Timeline's times are multiples of \a stepMilliseconds since the
+ *  TimeStamp epoch, which is a civil midnight, so daily steps fall on
+ *  midnights and hourly steps on the hour.  Its first step contains this
+ *  Timeline's first time and its last step contains the last time.
+ *
+ *  \param stepMilliseconds Step of the new Timeline.
+ *
+ *  \return The new Timeline, which is empty if this one is.
+ */
+
+Timeline Timeline::resample( long long stepMilliseconds ) const
+{
+    if ( m_count <= 0 || stepMilliseconds <= 0 )
+    {
+        return( Timeline( start(), stepMilliseconds, 0 ) );
+    }
+    long long i0 = floorDiv( m_start, stepMilliseconds );
+    long long i1 = floorDiv( milliseconds( m_count - 1 ), stepMilliseconds );
+    TimeStamp ts;
+    ts.addMilliseconds( i0 * stepMilliseconds );
+    return( Timeline( ts, stepMilliseconds, (int) ( i1 - i0 + 1 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the second of the minute of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Second of the minute (0-59).
+ */
+
+int Timeline::second( int index ) const
+{
+    return( fields( index )[5] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates the Timeline of a subrange of this Timeline's indices.
+ *
+ *  \param first First index of the subrange.
+ *  \param count Number of indices in the subrange.  The subrange is clipped
+ *  to this Timeline.
+ *
+ *  \return The new Timeline, whose index 0 is this Timeline's index
+ *  \a first.
+ */
+
+Timeline Timeline::slice( int first, int count ) const
+{
+    if ( first < 0 )
+    {
+        count += first;
+        first = 0;
+    }
+    if ( count > m_count - first )
+    {
+        count = m_count - first;
+    }
+    return( Timeline( at( first ), m_step, count ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the time of index 0.
+ *
+ *  \return TimeStamp of index 0.
+ */
+
+TimeStamp Timeline::start( void ) const
+{
+    return( at( 0 ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the milliseconds between consecutive indices.
+ *
+ *  \return Step in milliseconds.
+ */
+
+long long Timeline::step( void ) const
+{
+    return( m_step );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the Julian-Gregorian year of the time at \a index.
+ *
+ *  \param index Timeline index (0 to count()-1).
+ *
+ *  \return Julian-Gregorian year.
+ */
+
+int Timeline::year( int index ) const
+{
+    return( fields( index )[0] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Assignment operator.
+ *
+ *  The calendar field cache is discarded rather than copied.
+ *
+ *  \param tl Reference to an existing Timeline.
+ *
+ *  \return Reference to this Timeline.
+ */
+
+Timeline &Timeline::operator=( const Timeline &tl )
+{
+    if ( this != &tl )
+    {
+        delete[] m_fields;
+        m_fields = 0;
+        m_start  = tl.m_start;
+        m_step   = tl.m_step;
+        m_count  = tl.m_count;
+    }
+    return( *this );
+}
+
+//------------------------------------------------------------------------------
+//  End of timeline.cpp
+//------------------------------------------------------------------------------
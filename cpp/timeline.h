@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*! \file timeline.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Regular time series axis C++ API header.
+ *
+ *  The Timeline class describes the times of a regular (fixed-step) series
+ *  so that series records need not carry their own DateTime.
+ */
+
+#ifndef _TIMELINE_H_
+/*! \def _TIMELINE_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _TIMELINE_H_ 1
+
+// Custom include files
+#include "timestamp.h"
+
+//------------------------------------------------------------------------------
+/*! \class Timeline timeline.h
+ *
+ *  \brief The time axis of a regular series, defined by a start time, a step
+ *  and a count.
+ *
+ *  Index and time are related by integer arithmetic on TimeStamp
+ *  milliseconds, so at(), indexOf() and julianDate() are O(1).  Calendar
+ *  fields are computed for an index the first time they are requested and
+ *  cached, so repeated year(), month(), day() etc. queries are array loads.
+ *
+ *  Two Timelines with different starts or steps are related by index
+ *  arithmetic as well:
+ *  \arg overlap() gives the range of indices falling inside another Timeline,
+ *  \arg mapIndices() gives, for every index, the index of the other Timeline
+ *  step containing it, without a division per index, and
+ *  \arg resample() gives the coarser Timeline whose steps are aligned to
+ *  civil midnight and that covers this one.
+ *
+ *  An hourly-to-daily rollup, for example, is
+ *  \code
+ *  Timeline daily = hourly.resample( TimeStamp::MsPerDay );
+ *  hourly.mapIndices( daily, bin );
+ *  for ( int i = 0; i < hourly.count(); i++ )
+ *  {
+ *      total[ bin[i] ] += rain[i];
+ *  }
+ *  \endcode
+ *
+ *  \sa TimeStamp, DateTimeRange
+ */
+
+class Timeline
+{
+// Public methods
+public:
+    Timeline( const TimeStamp &start, long long stepMilliseconds, int count ) ;
+    Timeline( const Timeline &tl ) ;
+    ~Timeline( void ) ;
+    Timeline &operator=( const Timeline &tl ) ;
+
+    TimeStamp   at( int index ) const ;
+    void        calendarDate( int index, int *year, int *month, int *day,
+                    int *hour, int *minute, int *second,
+                    int *millisecond ) const ;
+    int         count( void ) const ;
+    int         day( int index ) const ;
+    int         hour( int index ) const ;
+    int         indexOf( const TimeStamp &ts ) const ;
+    double      julianDate( int index ) const ;
+    int         mapIndices( const Timeline &tl, int *index ) const ;
+    int         millisecond( int index ) const ;
+    int         minute( int index ) const ;
+    int         month( int index ) const ;
+    bool        overlap( const Timeline &tl, int *first, int *count ) const ;
+    Timeline    resample( long long stepMilliseconds ) const ;
+    int         second( int index ) const ;
+    Timeline    slice( int first, int count ) const ;
+    TimeStamp   start( void ) const ;
+    long long   step( void ) const ;
+    int         year( int index ) const ;
+
+    /*! \brief Gets the elapsed milliseconds since the TimeStamp epoch of the
+        time at \a index.
+    */
+    long long milliseconds( int index ) const
+        { return( m_start + (long long) index * m_step ); }
+
+// Private methods
+private:
+    const int  *fields( int index ) const ;
+
+    /*! \brief Integer division rounded toward negative infinity. */
+    static long long floorDiv( long long a, long long b )
+        { return( ( a >= 0 ) ? a / b : -( ( b - 1 - a ) / b ) ); }
+
+// Protected member data
+protected:
+    /*! \var long long m_start
+        \brief Elapsed milliseconds since the TimeStamp epoch of index 0.
+    */
+    long long m_start;
+    /*! \var long long m_step
+        \brief Milliseconds between consecutive indices (1 or more).
+    */
+    long long m_step;
+    /*! \var int m_count
+        \brief Number of indices.
+    */
+    int     m_count;
+    /*! \var int *m_fields
+        \brief Cached year, month, day, hour, minute, second, and millisecond
+        of each index, allocated on first use; a zero month marks an index
+        whose fields have not been computed.
+    */
+    mutable int *m_fields;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of timeline.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,420 @@
+//------------------------------------------------------------------------------
+/*! \file timestamp.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compact date-time value C++ source code.
+ *
+ *  The TimeStamp class is a compact alternative to DateTime for large
+ *  time series, interchangeable with DateTime and the Calendar-Date-Time
+ *  Library in cdtlib.c.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "datetime.h"
+#include "timestamp.h"
+
+// Standard include files
+#include <math.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new TimeStamp at the epoch (midnight, Jan 1, -4712).
+ */
+
+TimeStamp::TimeStamp( void ) :
+    m_ms(0),
+    m_event(CDT_User),
+    m_flag(CDT_HasValidDateTime)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new TimeStamp from a Julian date.
+ *
+ *  \param julianDate Julian date, rounded to the nearest millisecond.
+ */
+
+TimeStamp::TimeStamp( double julianDate ) :
+    m_ms(0),
+    m_event(CDT_User),
+    m_flag(CDT_None)
+{
+    set( julianDate );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new TimeStamp using the passed values.
+ *
+ *  \param year Julian-Gregorian year (-4712 or later).
+ *  \param month Month of the year (1=Jan, 12=Dec).
+ *  \param day Day of the month (1-31).
+ *  \param hour Hour of the day (0-23).
+ *  \param minute Minute of the hour (0-59).
+ *  \param second Second of the minute (0-59).
+ *  \param millisecond Millisecond of the second (0-999).
+ */
+
+TimeStamp::TimeStamp( int year, int month, int day, int hour, int minute,
+            int second, int millisecond ) :
+    m_ms(0),
+    m_event(CDT_User),
+    m_flag(CDT_None)
+{
+    set( year, month, day, hour, minute, second, millisecond );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs a new TimeStamp from a DateTime.
+ *
+ *  \param dt Reference to an existing DateTime object.
+ */
+
+TimeStamp::TimeStamp( const DateTime &dt ) :
+    m_ms(0),
+    m_event(CDT_User),
+    m_flag(CDT_None)
+{
+    set( dt );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds some number of decimal days to the current TimeStamp value.
+ *
+ *  \param days Number of decimal days to add, rounded to the nearest
+ *  millisecond; may be positive, zero, or negative.
+ *
+ *  \return TRUE if the resulting TimeStamp is valid, FALSE if it is earlier
+ *  than the epoch.
+ */
+
+bool TimeStamp::addDays( double days )
+{
+    return( addMilliseconds( (long long) floor( days * MsPerDay + 0.5 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds some number of milliseconds to the current TimeStamp value.
+ *
+ *  \param milliseconds Number of milliseconds to add;
+ *   may be positive, zero, or negative.
+ *
+ *  \return TRUE if the resulting TimeStamp is valid, FALSE if it is earlier
+ *  than the epoch.
+ */
+
+bool TimeStamp::addMilliseconds( long long milliseconds )
+{
+    m_ms += milliseconds;
+    m_event = CDT_User;
+    m_flag = ( m_ms >= 0 ) ? CDT_HasValidDateTime : CDT_HasInvalidYear;
+    return( m_ms >= 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines all the calendar date and time fields at once.
+ *
+ *  Calls CDT_DayNumberDate() and CDT_MillisecondTime() on the integral day
+ *  number and millisecond of the day, so there is no floating point
+ *  arithmetic.
+ *
+ *  \param *year Returned Julian-Gregorian calendar year.
+ *  \param *month Returned month of the year (1-12).
+ *  \param *day Returned day of the month (1-31).
+ *  \param *hour Returned hours past midnight (0-23).
+ *  \param *minute Returned minutes past the hour (0-59).
+ *  \param *second Returned seconds past the minute (0-59).
+ *  \param *millisecond Returned milliseconds past the second (0-999).
+ *
+ *  \return The function returns nothing.
+ */
+
+void TimeStamp::calendarDate( int *year, int *month, int *day, int *hour,
+        int *minute, int *second, int *millisecond ) const
+{
+    CDT_DayNumberDate( dayNumber(), year, month, day );
+    CDT_MillisecondTime( millisecondOfDay(), hour, minute, second,
+        millisecond );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp day of the month.
+ *
+ *  \return Day of the month (1-31).
+ */
+
+int TimeStamp::day( void ) const
+{
+    int y, mo, d, h, mi, s, ms;
+    calendarDate( &y, &mo, &d, &h, &mi, &s, &ms );
+    return( d );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp day of the week.
+ *
+ *  \return Day of the week index where 0=Sunday and 6=Saturday.
+ *
+ *  \sa CDT_DayOfWeek().
+ */
+
+int TimeStamp::dayOfWeek( void ) const
+{
+    return( ( dayNumber() + 1 ) % 7 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp #CDT_Event enumeration value.
+ *
+ *  \return #CDT_Event enumeration value.
+ */
+
+int TimeStamp::event( void ) const
+{
+    return( m_event );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp #CDT_Flag enumeration value.
+ *
+ *  \return #CDT_Flag enumeration value.
+ */
+
+int TimeStamp::flag( void ) const
+{
+    return( m_flag );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts an array of Julian dates into TimeStamps.
+ *
+ *  \param n Number of elements.
+ *  \param jdate Array of \a n Julian dates.
+ *  \param ts Returned array of \a n TimeStamps.
+ *
+ *  \return The function returns nothing.
+ */
+
+void TimeStamp::fromJulianDates( int n, const double *jdate, TimeStamp *ts )
+{
+    for ( int i = 0; i < n; i++ )
+    {
+        ts[i].set( jdate[i] );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp hour of the day.
+ *
+ *  \return Hour of the day (0-23).
+ */
+
+int TimeStamp::hour( void ) const
+{
+    return( millisecondOfDay() / 3600000 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp as a Julian date for use with the CDT library.
+ *
+ *  \return Julian date in decimal days since noon of Jan 1, -4712.
+ */
+
+double TimeStamp::julianDate( void ) const
+{
+    return( (double) dayNumber() - 0.5
+          + (double) millisecondOfDay() / 86400000. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp millisecond of the second.
+ *
+ *  \return Millisecond of the second (0-999).
+ */
+
+int TimeStamp::millisecond( void ) const
+{
+    return( millisecondOfDay() % 1000 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp minute of the hour.
+ *
+ *  \return Minute of the hour (0-59).
+ */
+
+int TimeStamp::minute( void ) const
+{
+    return( ( millisecondOfDay() / 60000 ) % 60 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp as a modified Julian date.
+ *
+ *  \return Modified Julian date in decimal days since midnight of Nov 17,
+ *  1858.
+ */
+
+double TimeStamp::modifiedJulianDate( void ) const
+{
+    return( (double) ( dayNumber() - 2400001 )
+          + (double) millisecondOfDay() / 86400000. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp month of the year.
+ *
+ *  \return Month of the year (1=Jan, 12=Dec).
+ */
+
+int TimeStamp::month( void ) const
+{
+    int y, mo, d, h, mi, s, ms;
+    calendarDate( &y, &mo, &d, &h, &mi, &s, &ms );
+    return( mo );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp second of the minute.
+ *
+ *  \return Second of the minute (0-59).
+ */
+
+int TimeStamp::second( void ) const
+{
+    return( ( millisecondOfDay() / 1000 ) % 60 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the TimeStamp from a Julian date.
+ *
+ *  \param julianDate Julian date, rounded to the nearest millisecond.
+ *
+ *  \return TRUE if the resulting TimeStamp is valid, FALSE if it is earlier
+ *  than the epoch.
+ */
+
+bool TimeStamp::set( double julianDate )
+{
+    long jdn;
+    int ms;
+    CDT_JulianDateSplit( julianDate, &jdn, &ms );
+    m_ms = (long long) jdn * MsPerDay + ms;
+    m_event = CDT_User;
+    m_flag = ( m_ms >= 0 ) ? CDT_HasValidDateTime : CDT_HasInvalidYear;
+    return( m_ms >= 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the TimeStamp from the passed calendar fields.
+ *
+ *  Out-of-range fields are folded into the result (e.g. hour 24 is midnight
+ *  of the following day), but the flag reports the first invalid field
+ *  just as DateTime::isValid() does.
+ *
+ *  \param year Julian-Gregorian year (-4712 or later).
+ *  \param month Month of the year (1=Jan, 12=Dec).
+ *  \param day Day of the month (1-31).
+ *  \param hour Hour of the day (0-23).
+ *  \param minute Minute of the hour (0-59).
+ *  \param second Second of the minute (0-59).
+ *  \param millisecond Millisecond of the second (0-999).
+ *
+ *  \return TRUE if the fields form a valid date and time, FALSE if not.
+ *  The invalid field can be determined from the flag() return code.
+ */
+
+bool TimeStamp::set( int year, int month, int day, int hour, int minute,
+        int second, int millisecond )
+{
+    m_ms = (long long) CDT_DayNumber( year, month, day ) * MsPerDay
+         + CDT_MillisecondOfDay( hour, minute, second, millisecond );
+    m_event = CDT_User;
+    m_flag = CDT_ValidDateTime( year, month, day,
+                hour, minute, second, millisecond );
+    return( m_flag == CDT_HasValidDateTime );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the TimeStamp from a DateTime.
+ *
+ *  The DateTime calendar fields (rather than its Julian date) are used, so
+ *  the conversion is exact.  The DateTime event and flag are retained.
+ *
+ *  \param dt Reference to an existing DateTime object.
+ *
+ *  \return TRUE if the DateTime is valid, FALSE if not.
+ */
+
+bool TimeStamp::set( const DateTime &dt )
+{
+    bool valid = set( dt.year(), dt.month(), dt.day(),
+        dt.hour(), dt.minute(), dt.second(), dt.millisecond() );
+    m_event = dt.event();
+    m_flag = dt.flag();
+    return( valid );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores the TimeStamp into a DateTime.
+ *
+ *  The calendar fields are set exactly, and the TimeStamp event and flag
+ *  are retained.
+ *
+ *  \param dt Reference to the DateTime to update.
+ *
+ *  \return The function returns nothing.
+ */
+
+void TimeStamp::toDateTime( DateTime &dt ) const
+{
+    int y, mo, d, h, mi, s, ms;
+    calendarDate( &y, &mo, &d, &h, &mi, &s, &ms );
+    dt.set( y, mo, d, h, mi, s, ms );
+    dt.m_event = m_event;
+    dt.m_flag = m_flag;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts an array of TimeStamps into Julian dates for use with the
+ *  CDT library batch functions.
+ *
+ *  \param n Number of elements.
+ *  \param ts Array of \a n TimeStamps.
+ *  \param jdate Returned array of \a n Julian dates.
+ *
+ *  \return The function returns nothing.
+ */
+
+void TimeStamp::toJulianDates( int n, const TimeStamp *ts, double *jdate )
+{
+    for ( int i = 0; i < n; i++ )
+    {
+        jdate[i] = ts[i].julianDate();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the TimeStamp Julian-Gregorian calendar year.
+ *
+ *  \return Julian-Gregorian calendar year.
+ */
+
+int TimeStamp::year( void ) const
+{
+    int y, mo, d, h, mi, s, ms;
+    calendarDate( &y, &mo, &d, &h, &mi, &s, &ms );
+    return( y );
+}
+
+//------------------------------------------------------------------------------
+//  End of timestamp.cpp
+//------------------------------------------------------------------------------
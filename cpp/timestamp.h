@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+/*! \file timestamp.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compact date-time value C++ API header.
+ *
+ *  The TimeStamp class is a compact alternative to DateTime for large
+ *  time series, interchangeable with DateTime and the Calendar-Date-Time
+ *  Library in cdtlib.c.
+ */
+
+#ifndef _TIMESTAMP_H_
+/*! \def _TIMESTAMP_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _TIMESTAMP_H_ 1
+
+// Forward class references
+class DateTime;
+
+//------------------------------------------------------------------------------
+/*! \class TimeStamp timestamp.h
+ *
+ *  \brief A 16-byte, trivially copyable date-time value.
+ *
+ *  A DateTime carries both its Julian date and its broken-down calendar
+ *  fields and recomputes both on every change.  A TimeStamp stores only the
+ *  integral number of milliseconds since midnight beginning Julian day 0
+ *  (Julian date -0.5, or Jan 1, -4712), plus the event and flag codes.  The
+ *  calendar fields are derived on request using integer arithmetic, so
+ *  arrays of TimeStamps are dense, exact, and may be copied with memcpy().
+ *
+ *  Because the epoch is a civil midnight, the Julian day number and the
+ *  millisecond of the day are a single division and remainder.
+ *
+ *  \sa DateTime, cdtlib.c
+ */
+
+class TimeStamp
+{
+// Public methods
+public:
+    TimeStamp( void ) ;
+    TimeStamp( double julianDate ) ;
+    TimeStamp( int year, int month, int day, int hour=0, int minute=0,
+                int second=0, int millisecond=0 ) ;
+    TimeStamp( const DateTime &dt ) ;
+
+    bool        addDays( double days ) ;
+    bool        addMilliseconds( long long milliseconds ) ;
+    void        calendarDate( int *year, int *month, int *day, int *hour,
+                    int *minute, int *second, int *millisecond ) const ;
+    int         day( void ) const ;
+    int         dayOfWeek( void ) const ;
+    int         event( void ) const ;
+    int         flag( void ) const ;
+    int         hour( void ) const ;
+    double      julianDate( void ) const ;
+    int         millisecond( void ) const ;
+    int         minute( void ) const ;
+    double      modifiedJulianDate( void ) const ;
+    int         month( void ) const ;
+    int         second( void ) const ;
+    bool        set( double julianDate ) ;
+    bool        set( int year, int month, int day, int hour=0, int minute=0,
+                    int second=0, int millisecond=0 ) ;
+    bool        set( const DateTime &dt ) ;
+    void        toDateTime( DateTime &dt ) const ;
+    int         year( void ) const ;
+
+    static void fromJulianDates( int n, const double *jdate, TimeStamp *ts ) ;
+    static void toJulianDates( int n, const TimeStamp *ts, double *jdate ) ;
+
+    /*! \brief Gets the Julian day number of the civil (midnight-to-midnight)
+        date, i.e. the Julian date at the following noon.
+    */
+    int  dayNumber( void ) const
+        { return( (int) floorDiv( m_ms, MsPerDay ) ); }
+    /*! \brief Gets the elapsed milliseconds since midnight (0-86399999). */
+    int  millisecondOfDay( void ) const
+        { return( (int) ( m_ms - MsPerDay * floorDiv( m_ms, MsPerDay ) ) ); }
+    /*! \brief Gets the elapsed milliseconds since the TimeStamp epoch. */
+    long long milliseconds( void ) const { return( m_ms ); }
+    /*! \brief Gets the milliseconds from \a ts until this TimeStamp. */
+    long long millisecondsSince( const TimeStamp &ts ) const
+        { return( m_ms - ts.m_ms ); }
+
+    bool operator==( const TimeStamp &ts ) const { return( m_ms == ts.m_ms ); }
+    bool operator!=( const TimeStamp &ts ) const { return( m_ms != ts.m_ms ); }
+    bool operator<( const TimeStamp &ts ) const { return( m_ms < ts.m_ms ); }
+    bool operator<=( const TimeStamp &ts ) const { return( m_ms <= ts.m_ms ); }
+    bool operator>( const TimeStamp &ts ) const { return( m_ms > ts.m_ms ); }
+    bool operator>=( const TimeStamp &ts ) const { return( m_ms >= ts.m_ms ); }
+
+    /*! \var MsPerDay
+        \brief Milliseconds per day.
+    */
+    static const long long MsPerDay = 86400000LL;
+
+// Private methods
+private:
+    /*! \brief Integer division rounded toward negative infinity. */
+    static long long floorDiv( long long a, long long b )
+        { return( ( a >= 0 ) ? a / b : -( ( b - 1 - a ) / b ) ); }
+
+// Protected member data
+protected:
+    /*! \var long long m_ms
+        \brief Elapsed milliseconds since midnight beginning Julian day 0.
+    */
+    long long m_ms;
+    /*! \var int m_event
+        \brief #CDT_Event enumeration value of the TimeStamp.
+    */
+    int     m_event;
+    /*! \var int m_flag
+        \brief #CDT_Flag enumeration value of the TimeStamp.
+    */
+    int     m_flag;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of timestamp.h
+//------------------------------------------------------------------------------
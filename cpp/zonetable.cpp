@@ -0,0 +1,1047 @@
+//------------------------------------------------------------------------------
+/*! \file zonetable.cpp
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compiled time zone rules table C++ source code.
+ *
+ *  The ZoneTable class holds the UTC offset transitions of a set of time
+ *  zones, compiled from a tzdata (zoneinfo) directory, so that local times
+ *  follow daylight saving and historical offset changes.
+ */
+
+// Custom include files
+#include "cdtlib.h"
+#include "zonetable.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+/*! \struct ZoneTableHeader
+ *
+ *  \brief Leading record of a compiled ZoneTable block.
+ *
+ *  The header is followed by the zone directory (4 ints per zone), the
+ *  transition Julian dates (doubles), the transition offsets (ints), and
+ *  the zone names.  The header and directory are a multiple of 8 bytes, so
+ *  the doubles are aligned.
+ */
+
+struct ZoneTableHeader
+{
+    char    magic[8];       /*!< "CDTZONE" */
+    int     zones;          /*!< Number of zones */
+    int     transitions;    /*!< Total transitions of all zones */
+    int     nameBytes;      /*!< Bytes of zone names */
+    int     lastYear;       /*!< Last year of expanded footer rules */
+};
+
+static const char   ZoneTableMagic[8] = "CDTZONE";
+static const double UnixEpoch = 2440587.5;
+
+//------------------------------------------------------------------------------
+/*! \struct ZoneRules
+ *
+ *  \brief Growable list of one zone's transitions while compiling.
+ */
+
+struct ZoneRules
+{
+    long long *time;        /*!< Unix time of each transition */
+    int     *offset;        /*!< UTC offset in seconds from each transition */
+    int     count;          /*!< Number of transitions */
+    int     capacity;       /*!< Allocated transitions */
+};
+
+//------------------------------------------------------------------------------
+/*! \struct PosixDate
+ *
+ *  \brief One date and time rule of a POSIX TZ string.
+ */
+
+struct PosixDate
+{
+    char    kind;           /*!< 'J' (Jn), 'N' (n), or 'M' (Mm.w.d) */
+    int     month;          /*!< Month of an 'M' rule (1-12) */
+    int     week;           /*!< Week of an 'M' rule (1-5, 5=last) */
+    int     day;            /*!< Weekday (0=Sun) or day of the year */
+    int     time;           /*!< Local seconds after midnight */
+};
+
+//------------------------------------------------------------------------------
+/*! \brief Appends a transition to a ZoneRules list.
+ *
+ *  A transition at the same time as the last one replaces it, an earlier
+ *  one is ignored, and one that does not change the offset is dropped.
+ *
+ *  \param rules Pointer to the list.
+ *  \param time Unix time of the transition.
+ *  \param offset UTC offset in seconds from the transition.
+ */
+
+static void AddTransition( ZoneRules *rules, long long time, int offset )
+{
+    if ( rules->count > 0 )
+    {
+        int last = rules->count - 1;
+        if ( time < rules->time[last] )
+        {
+            return;
+        }
+        if ( time == rules->time[last] )
+        {
+            rules->count--;
+        }
+        if ( rules->count > 0 && rules->offset[rules->count-1] == offset )
+        {
+            return;
+        }
+    }
+    if ( rules->count == rules->capacity )
+    {
+        int capacity = ( rules->capacity ) ? 2 * rules->capacity : 64;
+        long long *grownTime = new long long[ capacity ];
+        int *grownOffset = new int[ capacity ];
+        for ( int i = 0; i < rules->count; i++ )
+        {
+            grownTime[i] = rules->time[i];
+            grownOffset[i] = rules->offset[i];
+        }
+        delete[] rules->time;
+        delete[] rules->offset;
+        rules->time = grownTime;
+        rules->offset = grownOffset;
+        rules->capacity = capacity;
+    }
+    rules->time[rules->count] = time;
+    rules->offset[rules->count] = offset;
+    rules->count++;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads a big-endian signed integer.
+ *
+ *  \param p Pointer to the first byte.
+ *  \param bytes Number of bytes (4 or 8).
+ *
+ *  \return The integer value.
+ */
+
+static long long BigEndian( const unsigned char *p, int bytes )
+{
+    unsigned long long u = 0;
+    for ( int i = 0; i < bytes; i++ )
+    {
+        u = ( u << 8 ) | p[i];
+    }
+    if ( bytes < 8 && ( u & ( 1ULL << ( 8 * bytes - 1 ) ) ) )
+    {
+        u |= ~0ULL << ( 8 * bytes );
+    }
+    return( (long long) u );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses the [+-]hh[:mm[:ss]] time of a POSIX TZ string.
+ *
+ *  \param p Pointer to the time.
+ *  \param seconds Returned signed seconds.
+ *
+ *  \return Pointer past the time, or NULL if there is none.
+ */
+
+static const char *PosixTime( const char *p, int *seconds )
+{
+    int sign = 1;
+    if ( *p == '+' || *p == '-' )
+    {
+        sign = ( *p++ == '-' ) ? -1 : 1;
+    }
+    if ( *p < '0' || *p > '9' )
+    {
+        return( 0 );
+    }
+    int part[3] = { 0, 0, 0 };
+    for ( int i = 0; i < 3; i++ )
+    {
+        while ( *p >= '0' && *p <= '9' )
+        {
+            part[i] = 10 * part[i] + ( *p++ - '0' );
+        }
+        if ( i < 2 && *p == ':' )
+        {
+            p++;
+            continue;
+        }
+        break;
+    }
+    *seconds = sign * ( 3600 * part[0] + 60 * part[1] + part[2] );
+    return( p );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses a time zone abbreviation and UTC offset of a POSIX TZ
+ *  string.
+ *
+ *  \param p Pointer to the abbreviation.
+ *  \param offset Returned UTC offset in seconds east of GMT (POSIX offsets
+ *  are west of GMT).
+ *
+ *  \return Pointer past the offset, or NULL if it is malformed.  If the
+ *  abbreviation is not followed by an offset, \a offset is unchanged.
+ */
+
+static const char *PosixZone( const char *p, int *offset )
+{
+    const char *name = p;
+    if ( *p == '<' )
+    {
+        while ( *p && *p != '>' )
+        {
+            p++;
+        }
+        if ( *p++ != '>' )
+        {
+            return( 0 );
+        }
+    }
+    else
+    {
+        while ( ( *p >= 'A' && *p <= 'Z' ) || ( *p >= 'a' && *p <= 'z' ) )
+        {
+            p++;
+        }
+    }
+    if ( p - name < 3 )
+    {
+        return( 0 );
+    }
+    int seconds;
+    const char *q = PosixTime( p, &seconds );
+    if ( q )
+    {
+        *offset = -seconds;
+        return( q );
+    }
+    return( p );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses a ,date[/time] rule of a POSIX TZ string.
+ *
+ *  \param p Pointer to the comma.
+ *  \param date Returned date rule.
+ *
+ *  \return Pointer past the rule, or NULL if it is malformed.
+ */
+
+static const char *PosixRule( const char *p, PosixDate *date )
+{
+    if ( *p++ != ',' )
+    {
+        return( 0 );
+    }
+    date->kind = 'N';
+    date->month = date->week = date->day = 0;
+    date->time = 7200;
+    if ( *p == 'M' )
+    {
+        date->kind = 'M';
+        date->month = (int) strtol( p+1, (char **) &p, 10 );
+        if ( *p++ != '.' )
+        {
+            return( 0 );
+        }
+        date->week = (int) strtol( p, (char **) &p, 10 );
+        if ( *p++ != '.' )
+        {
+            return( 0 );
+        }
+        date->day = (int) strtol( p, (char **) &p, 10 );
+        if ( date->month < 1 || date->month > 12 || date->week < 1
+          || date->week > 5 || date->day < 0 || date->day > 6 )
+        {
+            return( 0 );
+        }
+    }
+    else
+    {
+        if ( *p == 'J' )
+        {
+            date->kind = 'J';
+            p++;
+        }
+        if ( *p < '0' || *p > '9' )
+        {
+            return( 0 );
+        }
+        date->day = (int) strtol( p, (char **) &p, 10 );
+    }
+    if ( *p == '/' )
+    {
+        p = PosixTime( p+1, &date->time );
+    }
+    return( p );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the Unix time at which a POSIX TZ date rule occurs.
+ *
+ *  \param date Reference to the date rule.
+ *  \param year Julian-Gregorian year.
+ *  \param offset UTC offset in seconds in effect before the transition.
+ *
+ *  \return Unix time of the transition.
+ */
+
+static long long PosixTransition( const PosixDate &date, int year, int offset )
+{
+    long jdn;
+    if ( date.kind == 'M' )
+    {
+        // Weekday of the first of the month (Julian day number 0 was a Monday)
+        long first = CDT_DayNumber( year, date.month, 1 );
+        int day = 1 + ( date.day - (int) ( ( first + 1 ) % 7 ) + 7 ) % 7
+                + 7 * ( date.week - 1 );
+        if ( day > CDT_DaysInMonth( year, date.month ) )
+        {
+            day -= 7;
+        }
+        jdn = first + day - 1;
+    }
+    else
+    {
+        jdn = CDT_DayNumber( year, 1, 1 ) + date.day;
+        if ( date.kind == 'J' )
+        {
+            // Jn counts 1-365 and never Feb 29
+            jdn -= ( CDT_LeapYear( year ) && date.day >= 60 ) ? 0 : 1;
+        }
+    }
+    return( ( (long long) jdn - 2440588LL ) * 86400LL
+          + date.time - offset );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Expands a POSIX TZ footer rule into transitions after the last
+ *  explicit transition, through \a lastYear.
+ *
+ *  Daylight rules are expanded from the year of the last explicit
+ *  transition, but never from before 1970.  tzdata only guarantees zone
+ *  history since 1970 (hence zone1970.tab), so a file with no explicit
+ *  transitions keeps its initial offset before then rather than having its
+ *  current rule projected back to the beginning of time.
+ *
+ *  \param tz The POSIX TZ string, terminated by a newline or null.
+ *  \param rules Pointer to the zone's transitions.
+ *  \param lastYear Last year to expand.
+ */
+
+static void ExpandPosix( const char *tz, ZoneRules *rules, int lastYear )
+{
+    int std = 0;
+    const char *p = PosixZone( tz, &std );
+    if ( ! p || *p == '\n' || *p == '\0' )
+    {
+        // No daylight time: the offset simply continues
+        if ( p )
+        {
+            long long from = ( rules->count ) ? rules->time[rules->count-1]
+                                              : -( 1LL << 62 );
+            AddTransition( rules, from + 1, std );
+        }
+        return;
+    }
+    int dst = std + 3600;
+    PosixDate start, end;
+    if ( ! ( p = PosixZone( p, &dst ) )
+      || ! ( p = PosixRule( p, &start ) )
+      || ! ( p = PosixRule( p, &end ) ) )
+    {
+        return;
+    }
+    // Start no earlier than 1970 (entry 0 is the initial offset, not a
+    // real transition)
+    int year = 1970;
+    if ( rules->count > 1 )
+    {
+        int y, m, d, h, mi, s, ms;
+        CDT_CalendarDate( UnixEpoch + rules->time[rules->count-1] / 86400.,
+            &y, &m, &d, &h, &mi, &s, &ms );
+        year = ( y > year ) ? y : year;
+    }
+    for ( ; year <= lastYear; year++ )
+    {
+        long long on  = PosixTransition( start, year, std );
+        long long off = PosixTransition( end, year, dst );
+        if ( on < off )
+        {
+            AddTransition( rules, on, dst );
+            AddTransition( rules, off, std );
+        }
+        else
+        {
+            AddTransition( rules, off, std );
+            AddTransition( rules, on, dst );
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses a TZif file into its transitions.
+ *
+ *  The 64-bit (version 2 and later) data block is used when present, and
+ *  its POSIX TZ footer is expanded through \a lastYear.  Leap second records
+ *  are ignored.
+ *
+ *  \param buf The file contents.
+ *  \param size Size of \a buf in bytes.
+ *  \param rules Pointer to the empty transitions list to fill.  The first
+ *  entry is the offset in effect before the first transition.
+ *  \param lastYear Last year to expand the footer rule.
+ *
+ *  \return TRUE if the file was parsed, FALSE if it is not a TZif file.
+ */
+
+static bool ParseTZif( const unsigned char *buf, long size, ZoneRules *rules,
+        int lastYear )
+{
+    const unsigned char *p = buf;
+    const unsigned char *end = buf + size;
+    int timeBytes = 4;
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        if ( end - p < 44 || memcmp( p, "TZif", 4 ) )
+        {
+            return( false );
+        }
+        int version = p[4];
+        long isut   = (long) BigEndian( p + 20, 4 );
+        long isstd  = (long) BigEndian( p + 24, 4 );
+        long leap   = (long) BigEndian( p + 28, 4 );
+        long times  = (long) BigEndian( p + 32, 4 );
+        long types  = (long) BigEndian( p + 36, 4 );
+        long chars  = (long) BigEndian( p + 40, 4 );
+        long block  = times * timeBytes + times + types * 6 + chars
+                    + leap * ( timeBytes + 4 ) + isstd + isut;
+        if ( types < 1 || end - p - 44 < block )
+        {
+            return( false );
+        }
+        p += 44;
+        if ( pass == 0 && version >= '2' )
+        {
+            // Skip the 32-bit block in favor of the 64-bit one
+            p += block;
+            timeBytes = 8;
+            continue;
+        }
+        const unsigned char *index = p + times * timeBytes;
+        const unsigned char *type = index + times;
+        AddTransition( rules, -( 1LL << 62 ),
+            (int) BigEndian( type, 4 ) );
+        for ( long i = 0; i < times; i++ )
+        {
+            int t = index[i];
+            if ( t >= types )
+            {
+                return( false );
+            }
+            AddTransition( rules, BigEndian( p + i * timeBytes, timeBytes ),
+                (int) BigEndian( type + 6 * t, 4 ) );
+        }
+        p += block;
+        if ( timeBytes == 8 && p < end && *p == '\n' )
+        {
+            // Make sure the footer is terminated before parsing it
+            const unsigned char *q = p + 1;
+            while ( q < end && *q != '\n' )
+            {
+                q++;
+            }
+            if ( q < end && q > p + 1 )
+            {
+                ExpandPosix( (const char *) p + 1, rules, lastYear );
+            }
+        }
+        return( true );
+    }
+    return( false );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructs an empty ZoneTable.
+ */
+
+ZoneTable::ZoneTable( void ) :
+    m_block(0),
+    m_size(0),
+    m_mapped(false),
+    m_count(0),
+    m_zone(0),
+    m_jdate(0),
+    m_offset(0),
+    m_names(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ZoneTable destructor.
+ */
+
+ZoneTable::~ZoneTable( void )
+{
+    release();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adopts a compiled block as the ZoneTable's contents.
+ *
+ *  \param block Pointer to the block, allocated by new[] or mapped.
+ *  \param size Size of the block in bytes.
+ *  \param mapped TRUE if the block is memory-mapped.
+ *
+ *  The header sizes must add up to \a size, and every directory entry's
+ *  name offset and transition range must lie within the block, with the
+ *  names null-terminated, so that a truncated or corrupt file is rejected
+ *  rather than read out of bounds.
+ *
+ *  \return TRUE if the block is a valid compiled table, FALSE if not (in
+ *  which case the block is released and the table is empty).
+ */
+
+bool ZoneTable::attach( char *block, long size, bool mapped )
+{
+    release();
+    m_block = block;
+    m_size = size;
+    m_mapped = mapped;
+    const ZoneTableHeader *h = (const ZoneTableHeader *) block;
+    if ( size < (long) sizeof( ZoneTableHeader )
+      || memcmp( h->magic, ZoneTableMagic, 8 )
+      || h->zones < 0 || h->transitions < 0 || h->nameBytes < 0
+      || size != (long) sizeof( ZoneTableHeader ) + 16L * h->zones
+               + 12L * h->transitions + h->nameBytes )
+    {
+        release();
+        return( false );
+    }
+    const int *zone = (const int *) ( block + sizeof( ZoneTableHeader ) );
+    const char *names = block + size - h->nameBytes;
+    // Every zone needs a name and at least its initial offset
+    if ( h->zones > 0 && ( h->nameBytes < 1 || names[h->nameBytes-1] ) )
+    {
+        release();
+        return( false );
+    }
+    for ( int z = 0; z < h->zones; z++ )
+    {
+        if ( zone[4*z] < 0 || zone[4*z] >= h->nameBytes
+          || zone[4*z+1] < 0 || zone[4*z+2] < 1
+          || (long) zone[4*z+1] + zone[4*z+2] > (long) h->transitions )
+        {
+            release();
+            return( false );
+        }
+    }
+    m_count  = h->zones;
+    m_zone   = zone;
+    m_jdate  = (const double *) ( m_zone + 4 * m_count );
+    m_offset = (const int *) ( m_jdate + h->transitions );
+    m_names  = names;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compiles the ZoneTable from the TZif files of a tzdata directory.
+ *
+ *  Any previous contents are discarded.
+ *
+ *  \param directory Path of the tzdata (zoneinfo) directory,
+ *  e.g. "/usr/share/zoneinfo".
+ *  \param zoneNames Array of \a zones zone names, e.g. "America/Denver",
+ *  or NULL to compile every zone listed in the directory's zone1970.tab.
+ *  \param zones Number of names in \a zoneNames.
+ *  \param lastYear Last year through which each zone's current daylight
+ *  saving rule is expanded into transitions.  Later dates keep the offset
+ *  of the last transition.
+ *
+ *  \return Number of zones compiled.  Zones whose files are missing or
+ *  invalid are skipped.
+ */
+
+int ZoneTable::compile( const char *directory, const char **zoneNames,
+        int zones, int lastYear )
+{
+    release();
+
+    // Get the zone names from zone1970.tab if none were passed
+    char *tab = 0;
+    const char **names = zoneNames;
+    char path[1024];
+    if ( ! names )
+    {
+        sprintf( path, "%.1000s/zone1970.tab", directory );
+        FILE *fptr = fopen( path, "rb" );
+        if ( ! fptr )
+        {
+            return( 0 );
+        }
+        fseek( fptr, 0L, SEEK_END );
+        long size = ftell( fptr );
+        fseek( fptr, 0L, SEEK_SET );
+        tab = new char[ size + 1 ];
+        size = (long) fread( tab, 1, size, fptr );
+        tab[size] = '\0';
+        fclose( fptr );
+        zones = 0;
+        for ( long i = 0; i < size; i++ )
+        {
+            zones += ( tab[i] == '\n' );
+        }
+        names = new const char *[ zones + 1 ];
+        zones = 0;
+        for ( char *line = strtok( tab, "\n" ); line;
+              line = strtok( 0, "\n" ) )
+        {
+            if ( *line == '#' )
+            {
+                continue;
+            }
+            // The zone name is the third tab-separated field
+            char *name = strchr( line, '\t' );
+            name = ( name ) ? strchr( name + 1, '\t' ) : 0;
+            if ( name )
+            {
+                char *stop = strchr( ++name, '\t' );
+                if ( stop )
+                {
+                    *stop = '\0';
+                }
+                names[zones++] = name;
+            }
+        }
+    }
+
+    // Parse each zone's file
+    ZoneRules *rules = new ZoneRules[ zones ];
+    int *order = new int[ zones ];
+    int compiled = 0;
+    int transitions = 0;
+    int nameBytes = 0;
+    for ( int z = 0; z < zones; z++ )
+    {
+        rules[z].time = 0;
+        rules[z].offset = 0;
+        rules[z].count = rules[z].capacity = 0;
+        sprintf( path, "%.500s/%.500s", directory, names[z] );
+        FILE *fptr = fopen( path, "rb" );
+        if ( ! fptr )
+        {
+            continue;
+        }
+        fseek( fptr, 0L, SEEK_END );
+        long size = ftell( fptr );
+        fseek( fptr, 0L, SEEK_SET );
+        unsigned char *buf = new unsigned char[ size + 1 ];
+        size = (long) fread( buf, 1, size, fptr );
+        fclose( fptr );
+        if ( ParseTZif( buf, size, &rules[z], lastYear ) )
+        {
+            order[compiled++] = z;
+            transitions += rules[z].count;
+            nameBytes += (int) strlen( names[z] ) + 1;
+        }
+        delete[] buf;
+    }
+    // Sort the compiled zones by name (insertion sort; the list is short)
+    for ( int i = 1; i < compiled; i++ )
+    {
+        int z = order[i];
+        int j = i;
+        for ( ; j > 0 && strcmp( names[z], names[ order[j-1] ] ) < 0; j-- )
+        {
+            order[j] = order[j-1];
+        }
+        order[j] = z;
+    }
+
+    // Lay out the block
+    long size = (long) sizeof( ZoneTableHeader ) + 16L * compiled
+              + 12L * transitions + nameBytes;
+    char *block = new char[ size ];
+    ZoneTableHeader *h = (ZoneTableHeader *) block;
+    memcpy( h->magic, ZoneTableMagic, 8 );
+    h->zones = compiled;
+    h->transitions = transitions;
+    h->nameBytes = nameBytes;
+    h->lastYear = lastYear;
+    int *dir = (int *) ( block + sizeof( ZoneTableHeader ) );
+    double *jdate = (double *) ( dir + 4 * compiled );
+    int *offset = (int *) ( jdate + transitions );
+    char *text = (char *) ( offset + transitions );
+    int first = 0;
+    int textSize = 0;
+    for ( int i = 0; i < compiled; i++ )
+    {
+        ZoneRules *r = &rules[ order[i] ];
+        dir[4*i]   = textSize;
+        dir[4*i+1] = first;
+        dir[4*i+2] = r->count;
+        dir[4*i+3] = 0;
+        strcpy( text + textSize, names[ order[i] ] );
+        textSize += (int) strlen( names[ order[i] ] ) + 1;
+        for ( int j = 0; j < r->count; j++ )
+        {
+            // The first entry applies from the beginning of time
+            jdate[first+j] = ( j == 0 ) ? -HUGE_VAL
+                           : UnixEpoch + (double) r->time[j] / 86400.;
+            offset[first+j] = r->offset[j];
+        }
+        first += r->count;
+    }
+    for ( int z = 0; z < zones; z++ )
+    {
+        delete[] rules[z].time;
+        delete[] rules[z].offset;
+    }
+    delete[] rules;
+    delete[] order;
+    if ( tab )
+    {
+        delete[] names;
+        delete[] tab;
+    }
+    attach( block, size, false );
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of zones in the ZoneTable.
+ *
+ *  \return Number of zones.
+ */
+
+int ZoneTable::count( void ) const
+{
+    return( m_count );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the UTC offset of a zone at a local Julian date.
+ *
+ *  Each transition takes effect at its local wall clock time in the offset
+ *  before it.  So in the hour repeated when clocks are set back the earlier
+ *  (daylight) offset is returned, and in the hour skipped when clocks are
+ *  set forward the new offset is returned.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *  \param jdate Local Julian date.
+ *
+ *  \return UTC offset in hours east of GMT, or 0 for an invalid \a zone.
+ */
+
+double ZoneTable::localOffsetAt( int zone, double jdate ) const
+{
+    if ( zone < 0 || zone >= m_count )
+    {
+        return( 0. );
+    }
+    int first = m_zone[4*zone+1];
+    int last = first + m_zone[4*zone+2] - 1;
+    int k = search( zone, jdate );
+    k = search( zone, jdate - m_offset[k] / 86400. );
+    while ( k < last && jdate >= m_jdate[k+1] + m_offset[k] / 86400. )
+    {
+        k++;
+    }
+    while ( k > first && jdate < m_jdate[k] + m_offset[k-1] / 86400. )
+    {
+        k--;
+    }
+    return( m_offset[k] / 3600. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the name of a zone.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *
+ *  \return Pointer to the zone name, or to an empty string for an invalid
+ *  \a zone.
+ */
+
+const char *ZoneTable::name( int zone ) const
+{
+    if ( zone < 0 || zone >= m_count )
+    {
+        return( "" );
+    }
+    return( m_names + m_zone[4*zone] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the UTC offset of a zone at a GMT Julian date.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *  \param jdate GMT Julian date.
+ *
+ *  \return UTC offset in hours east of GMT, or 0 for an invalid \a zone.
+ */
+
+double ZoneTable::offsetAt( int zone, double jdate ) const
+{
+    if ( zone < 0 || zone >= m_count )
+    {
+        return( 0. );
+    }
+    return( m_offset[ search( zone, jdate ) ] / 3600. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Opens a ZoneTable previously saved by write().
+ *
+ *  On POSIX systems the file is memory-mapped read-only, so its pages are
+ *  shared by every process using it; elsewhere it is read into memory.
+ *
+ *  \param fileName Name of the compiled table file.
+ *
+ *  \return TRUE if the file is a valid compiled table, FALSE if not.
+ */
+
+bool ZoneTable::open( const char *fileName )
+{
+    release();
+#ifndef _WIN32
+    int fd = ::open( fileName, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return( false );
+    }
+    struct stat st;
+    void *map = MAP_FAILED;
+    if ( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        map = mmap( 0, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+    close( fd );
+    if ( map == MAP_FAILED )
+    {
+        return( false );
+    }
+    return( attach( (char *) map, (long) st.st_size, true ) );
+#else
+    FILE *fptr = fopen( fileName, "rb" );
+    if ( ! fptr )
+    {
+        return( false );
+    }
+    fseek( fptr, 0L, SEEK_END );
+    long size = ftell( fptr );
+    fseek( fptr, 0L, SEEK_SET );
+    char *block = new char[ size ];
+    bool ok = ( (long) fread( block, 1, size, fptr ) == size );
+    fclose( fptr );
+    if ( ! ok )
+    {
+        delete[] block;
+        return( false );
+    }
+    return( attach( block, size, false ) );
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases the ZoneTable's block, leaving an empty table.
+ */
+
+void ZoneTable::release( void )
+{
+    if ( m_block )
+    {
+#ifndef _WIN32
+        if ( m_mapped )
+        {
+            munmap( m_block, (size_t) m_size );
+        }
+        else
+#endif
+        {
+            delete[] m_block;
+        }
+    }
+    m_block  = 0;
+    m_size   = 0;
+    m_mapped = false;
+    m_count  = 0;
+    m_zone   = 0;
+    m_jdate  = 0;
+    m_offset = 0;
+    m_names  = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the transition of a zone in effect at a GMT Julian date.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *  \param jdate GMT Julian date.
+ *
+ *  \return Index of the last transition of the zone at or before \a jdate.
+ */
+
+int ZoneTable::search( int zone, double jdate ) const
+{
+    int lo = m_zone[4*zone+1];
+    int hi = lo + m_zone[4*zone+2] - 1;
+    // m_jdate[lo] is -HUGE_VAL, so the answer is in [lo, hi]
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi + 1 ) / 2;
+        if ( m_jdate[mid] <= jdate )
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return( lo );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts an array of GMT Julian dates into local Julian dates for
+ *  a zone.
+ *
+ *  The transition in effect is only searched for when a date falls outside
+ *  the previous date's offset period, so for time-ordered input the loop
+ *  is one compare and one add per date.  \a gmtJdate and \a localJdate may
+ *  be the same array.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *  \param n Number of dates.
+ *  \param gmtJdate Array of \a n GMT Julian dates.
+ *  \param localJdate Array of \a n returned local Julian dates.
+ */
+
+void ZoneTable::toLocal( int zone, int n, const double *gmtJdate,
+        double *localJdate ) const
+{
+    if ( zone < 0 || zone >= m_count )
+    {
+        for ( int i = 0; i < n; i++ )
+        {
+            localJdate[i] = gmtJdate[i];
+        }
+        return;
+    }
+    int last = m_zone[4*zone+1] + m_zone[4*zone+2] - 1;
+    double lo = HUGE_VAL;
+    double hi = -HUGE_VAL;
+    double days = 0.;
+    for ( int i = 0; i < n; i++ )
+    {
+        double jdate = gmtJdate[i];
+        if ( jdate < lo || jdate >= hi )
+        {
+            int k = search( zone, jdate );
+            lo = m_jdate[k];
+            hi = ( k < last ) ? m_jdate[k+1] : HUGE_VAL;
+            days = m_offset[k] / 86400.;
+        }
+        localJdate[i] = jdate + days;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the number of offset transitions of a zone.
+ *
+ *  \param zone Zone handle (0 to count()-1).
+ *
+ *  \return Number of transitions, including those expanded from the zone's
+ *  current rule, or 0 for an invalid \a zone.
+ */
+
+int ZoneTable::transitions( int zone ) const
+{
+    if ( zone < 0 || zone >= m_count )
+    {
+        return( 0 );
+    }
+    return( m_zone[4*zone+2] - 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Saves the compiled ZoneTable for later use by open().
+ *
+ *  \param fileName Name of the file to create.
+ *
+ *  \return TRUE if the file was written, FALSE if not.
+ */
+
+bool ZoneTable::write( const char *fileName ) const
+{
+    if ( ! m_block )
+    {
+        return( false );
+    }
+    FILE *fptr = fopen( fileName, "wb" );
+    if ( ! fptr )
+    {
+        return( false );
+    }
+    bool ok = ( (long) fwrite( m_block, 1, m_size, fptr ) == m_size );
+    return( ( fclose( fptr ) == 0 ) && ok );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds a zone by name.
+ *
+ *  \param name Zone name, e.g. "America/Denver".
+ *
+ *  \return Zone handle, or -1 if the zone is not in the table.
+ */
+
+int ZoneTable::zone( const char *name ) const
+{
+    int lo = 0;
+    int hi = m_count - 1;
+    while ( lo <= hi )
+    {
+        int mid = ( lo + hi ) / 2;
+        int cmp = strcmp( name, m_names + m_zone[4*mid] );
+        if ( cmp == 0 )
+        {
+            return( mid );
+        }
+        if ( cmp < 0 )
+        {
+            hi = mid - 1;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return( -1 );
+}
+
+//------------------------------------------------------------------------------
+//  End of zonetable.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+/*! \file zonetable.h
+ *  \version BehavePlus3
+ *  \author Copyright (C) 2002-2018 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Compiled time zone rules table C++ API header.
+ *
+ *  The ZoneTable class holds the UTC offset transitions of a set of time
+ *  zones, compiled from a tzdata (zoneinfo) directory, so that local times
+ *  follow daylight saving and historical offset changes.
+ */
+
+#ifndef _ZONETABLE_H_
+/*! \def _ZONETABLE_H_
+ *  \brief Prevents redundant includes.
+ */
+#define _ZONETABLE_H_ 1
+
+//------------------------------------------------------------------------------
+/*! \class ZoneTable zonetable.h
+ *
+ *  \brief Sorted UTC offset transitions of named time zones.
+ *
+ *  compile() reads the TZif files of a tzdata directory (such as
+ *  /usr/share/zoneinfo).  Each file's explicit transitions are kept, and its
+ *  POSIX TZ footer rule is expanded into explicit transitions through
+ *  \a lastYear, so every lookup is a single binary search.
+ *
+ *  The table is one contiguous, pointer-free block: a header, a zone
+ *  directory sorted by name, the GMT Julian dates of all transitions, their
+ *  UTC offsets, and the zone names.  write() saves the block as is, and
+ *  open() maps (or reads) a saved block back in without any parsing.  The
+ *  block uses the native byte order, so files are only portable between
+ *  machines of the same byte order.
+ *
+ *  Offsets are in hours east of GMT, the same convention as
+ *  GlobalPosition::gmtDiff().
+ *
+ *  \sa GlobalPosition::zoneTable()
+ */
+
+class ZoneTable
+{
+// Public methods
+public:
+    ZoneTable( void ) ;
+    ~ZoneTable( void ) ;
+
+    int         compile( const char *directory, const char **zoneNames=0,
+                    int zones=0, int lastYear=2100 ) ;
+    int         count( void ) const ;
+    double      localOffsetAt( int zone, double jdate ) const ;
+    const char *name( int zone ) const ;
+    double      offsetAt( int zone, double jdate ) const ;
+    bool        open( const char *fileName ) ;
+    void        toLocal( int zone, int n, const double *gmtJdate,
+                    double *localJdate ) const ;
+    int         transitions( int zone ) const ;
+    bool        write( const char *fileName ) const ;
+    int         zone( const char *name ) const ;
+
+// Private methods
+private:
+    ZoneTable( const ZoneTable &zt ) ;
+    ZoneTable &operator=( const ZoneTable &zt ) ;
+    bool        attach( char *block, long size, bool mapped ) ;
+    void        release( void ) ;
+    int         search( int zone, double jdate ) const ;
+
+// Protected member data
+protected:
+    /*! \var char *m_block
+        \brief The compiled table (see #ZoneTableHeader in zonetable.cpp).
+    */
+    char   *m_block;
+    /*! \var long m_size
+        \brief Size of #m_block in bytes.
+    */
+    long    m_size;
+    /*! \var bool m_mapped
+        \brief TRUE if #m_block is a memory-mapped file rather than new[].
+    */
+    bool    m_mapped;
+    /*! \var int m_count
+        \brief Number of zones in the table.
+    */
+    int     m_count;
+    /*! \var const int *m_zone
+        \brief Zone directory: name offset, first transition, and
+        transition count of each zone, four ints per zone.
+    */
+    const int *m_zone;
+    /*! \var const double *m_jdate
+        \brief GMT Julian date of each transition, ascending within a zone.
+    */
+    const double *m_jdate;
+    /*! \var const int *m_offset
+        \brief UTC offset in seconds in effect from each transition.
+    */
+    const int *m_offset;
+    /*! \var const char *m_names
+        \brief Null-terminated zone names, in directory order.
+    */
+    const char *m_names;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of zonetable.h
+//------------------------------------------------------------------------------